@@ -0,0 +1,175 @@
+-- Benchmark mode: measures the performance of the heaviest maps.
+--
+-- It is enabled if there is a file called "benchmark" in the write directory,
+-- or if the environment variable ZSDX_BENCHMARK is set
+-- (see the benchmark target of CMakeLists.txt).
+--
+-- Instead of the menus, a game is started from benchmark.dat in the write
+-- directory (never saved), or from a new savegame if this file does not exist.
+-- The hero is sent to each map of the list below and stays there during a few
+-- seconds. Then the results are written to benchmark_results.csv in the write
+-- directory and the program stops.
+--
+-- On each map, the hero replays the commands of benchmark_<map_id>.dat in the
+-- write directory if this file exists (see input_recorder.lua), or walks in a
+-- square otherwise. To record such a file, teleport to the map and type in
+-- the console: game:start_input_recording("benchmark_44.dat")
+--
+-- For each map, the results are the time to load the map (the real time,
+-- including file reads, and the processor time), the percentiles of the
+-- processor time spent by each frame and the peak memory used by Lua.
+
+local real_clock = require("real_clock")
+
+local benchmark = {}
+
+-- Maps measured, in this order.
+local map_ids = {
+  "44",   -- Enemies testing arena.
+  "3",    -- Outside world A3.
+  "4",    -- Outside world B3.
+  "5",    -- Outside world B4.
+  "6",    -- Outside world A4.
+  "7",    -- Outside world B2.
+  "8",    -- Outside world A1.
+  "9",    -- Outside world A2.
+  "10",   -- Outside world B1.
+  "105",  -- Dungeon 9 1F.
+  "110",  -- Dungeon 9 6F.
+}
+
+local results_file_name = "benchmark_results.csv"
+local stay_delay = 10000        -- Time spent on each map.
+local walk_step_delay = 1000    -- The hero walks in a square.
+local walk_commands = { "right", "down", "left", "up" }
+
+-- Returns the value at a percentile of a sorted array.
+local function get_percentile(values, percentile)
+
+  if #values == 0 then
+    return 0
+  end
+  local index = math.max(1, math.ceil(#values * percentile / 100))
+  return values[index]
+end
+
+local function write_results(results)
+
+  local file = sol.file.open(results_file_name, "w")
+  file:write("map,load_ms,load_cpu_ms,frames,frame_p50_ms,frame_p90_ms,frame_p99_ms,frame_max_ms,peak_lua_kb\n")
+  for _, result in ipairs(results) do
+    local frame_times = result.frame_times
+    table.sort(frame_times)
+    file:write(string.format("%s,%.1f,%.1f,%d,%.3f,%.3f,%.3f,%.3f,%.1f\n",
+        result.map_id,
+        result.load_ms,
+        result.load_cpu_ms,
+        #frame_times,
+        get_percentile(frame_times, 50),
+        get_percentile(frame_times, 90),
+        get_percentile(frame_times, 99),
+        frame_times[#frame_times] or 0,
+        result.peak_lua_kb))
+  end
+  file:close()
+  print("Benchmark results written to " .. sol.main.get_quest_write_dir()
+      .. "/" .. results_file_name)
+end
+
+-- Starts the game and measures each map.
+function benchmark.start()
+
+  local game = sol.game.load("benchmark.dat")
+  if not sol.game.exists("benchmark.dat") then
+    game:set_value("player_name", "Bench")
+    game:set_max_life(80)
+    game:set_life(game:get_max_life())
+    game:get_item("tunic"):set_variant(1)
+    game:set_ability("tunic", 1)
+    game:get_item("rupee_bag"):set_variant(1)
+  end
+  game:set_starting_location(map_ids[1])
+
+  local results = {}
+  local result = nil
+  local map_index = 1
+  local load_start_time = real_clock.get_time()
+  local load_start_clock = os.clock()
+  local last_frame_clock = nil
+  local walk_index = 0
+
+  -- Measures each frame.
+  local frame_menu = {}
+  function frame_menu:on_draw()
+
+    if result == nil then
+      return
+    end
+    local clock = os.clock()
+    if last_frame_clock ~= nil then
+      result.frame_times[#result.frame_times + 1] = (clock - last_frame_clock) * 1000
+    end
+    last_frame_clock = clock
+    result.peak_lua_kb = math.max(result.peak_lua_kb, collectgarbage("count"))
+  end
+
+  local function next_map()
+
+    map_index = map_index + 1
+    if map_ids[map_index] == nil then
+      write_results(results)
+      sol.main.exit()
+      return
+    end
+    result = nil
+    game:stop_input_replay()
+    load_start_time = real_clock.get_time()
+    load_start_clock = os.clock()
+    game:get_hero():teleport(map_ids[map_index], nil, "immediate")
+  end
+
+  local function walk()
+
+    if walk_index > 0 then
+      game:simulate_command_released(walk_commands[walk_index])
+    end
+    walk_index = walk_index % #walk_commands + 1
+    game:simulate_command_pressed(walk_commands[walk_index])
+  end
+
+  require("play_game")(game)
+  local on_map_changed = game.on_map_changed
+  function game:on_map_changed(map)
+
+    on_map_changed(self, map)
+
+    result = {
+      map_id = map:get_id(),
+      load_ms = real_clock.get_time() - load_start_time,
+      load_cpu_ms = (os.clock() - load_start_clock) * 1000,
+      frame_times = {},
+      peak_lua_kb = collectgarbage("count"),
+    }
+    results[#results + 1] = result
+    last_frame_clock = nil
+
+    self:get_hero():set_invincible(true)
+    if not self:is_replaying_inputs()
+        and not self:start_input_replay("benchmark_" .. map:get_id() .. ".dat") then
+      sol.timer.start(map, walk_step_delay, function()
+        -- Skip the dialogs of the map.
+        if self:is_dialog_enabled() then
+          self:simulate_command_pressed("action")
+          self:simulate_command_released("action")
+        end
+        walk()
+        return true
+      end)
+    end
+    sol.timer.start(map, stay_delay, next_map)
+  end
+
+  sol.menu.start(game, frame_menu)
+end
+
+return benchmark
@@ -1,5 +1,8 @@
 -- A Lua console that can be enabled with F12 at any time during the program.
 
+local memory_tracker = require("memory_tracker")
+local profiler = require("profiler")
+
 local console = {
   enabled = false,
   color = { 64, 64, 64 },  -- Background color of the console area.
@@ -155,6 +158,10 @@ function console.environment_index(environment, key)
   if key == "print" then
     -- Redefine print to output into the console.
     result = console.print
+  elseif key == "profiler" then
+    result = profiler
+  elseif key == "memory" then
+    result = memory_tracker
   else
     local game = sol.main.game
     if game ~= nil then
@@ -2,6 +2,9 @@ local enemy = ...
 
 -- Billy
 
+local hero_proximity = require("enemies/lib/hero_proximity")
+local movement_pool = require("enemies/lib/movement_pool")
+
 local going_hero = false
 
 function enemy:on_created()
@@ -17,6 +20,12 @@ function enemy:on_created()
   self:set_origin(8, 13)
   self:set_invincible()
   self:set_attack_consequence("sword", 1)
+
+  hero_proximity.watch(self, {
+    delay = 1000,
+    ignore_layer = true,
+    on_changed = function() self:check_hero() end,
+  })
 end
 
 function enemy:on_movement_changed()
@@ -42,24 +51,23 @@ end
 
 function enemy:check_hero()
 
-  local near_hero = self:get_distance(self:get_map():get_entity("hero")) < 100
+  local near_hero = hero_proximity.is_hero_near(self)
   if near_hero and not going_hero then
     self:go_hero()
   elseif not near_hero and going_hero then
     self:go_random()
   end
-  sol.timer.start(self, 1000, function() self:check_hero() end)
 end
 
 function enemy:go_random()
-  local m = sol.movement.create("random_path")
+  local m = movement_pool.get(self, "random_path")
   m:set_speed(48)
   m:start(self)
   going_hero = false
 end
 
 function enemy:go_hero()
-  local m = sol.movement.create("target")
+  local m = movement_pool.get(self, "target")
   m:set_speed(72)
   m:start(self)
   going_hero = true
@@ -2,11 +2,13 @@ local enemy = ...
 
 -- A blue flame shot by another enemy.
 
+local palettes = require("enemies/lib/palettes")
+
 function enemy:on_created()
 
   self:set_life(1)
   self:set_damage(8)
-  self:create_sprite("enemies/blue_flame")
+  palettes.create_sprite(self, "enemies/blue_flame")
   self:set_size(16, 16)
   self:set_origin(8, 13)
   self:set_invincible()
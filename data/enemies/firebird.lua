@@ -47,7 +47,8 @@ function enemy:prepare_flames()
   local life_lost = initial_life - self:get_life()
   local nb_to_create = 3 + life_lost
 
-  function repeat_throw_flame()
+  -- One timer repeated until all flames are thrown.
+  local function repeat_throw_flame()
     sol.audio.play_sound("lamp")
     nb_sons_created = nb_sons_created + 1
     local son_name = prefix .. nb_sons_created
@@ -59,11 +60,11 @@ function enemy:prepare_flames()
       layer = 0,
     }
     nb_to_create = nb_to_create - 1
-    if nb_to_create > 0 then
-      sol.timer.start(self, 200, repeat_throw_flame)
-    end
+    return nb_to_create > 0
+  end
+  if repeat_throw_flame() then
+    sol.timer.start(self, 200, repeat_throw_flame)
   end
-  repeat_throw_flame()
 
   sol.timer.start(self, math.random(4000, 6000), function()
     self:prepare_flames()
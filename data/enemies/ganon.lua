@@ -1,4 +1,5 @@
 local enemy = ...
+local movement_pool = require("enemies/lib/movement_pool")
 
 -- Ganon - final boss
 
@@ -60,7 +61,7 @@ function enemy:on_restarted()
 
   if not jumping and not attacking then
     if not vulnerable then
-      m = sol.movement.create("path_finding")
+      local m = movement_pool.get(self, "path_finding")
       m:set_speed(64)
       m:start(self)
       self:set_hurt_style("normal")
@@ -158,6 +159,7 @@ function enemy:destroy_floor(prefix, first, last)
   local index = first
   local delay = 30
 
+  -- One timer repeated until the last entity.
   local function repeat_change()
     if index % 10 == 1 then
       sol.audio.play_sound("stone")
@@ -165,12 +167,13 @@ function enemy:destroy_floor(prefix, first, last)
 
     self:get_map():get_entity(prefix .. index):set_enabled(false)
 
-    if index ~= last then
-      sol.timer.start(self:get_map(), delay, repeat_change)
-    end
+    local finished = index == last
     index = index + 1
+    return not finished
+  end
+  if repeat_change() then
+    sol.timer.start(self:get_map(), delay, repeat_change)
   end
-  repeat_change()
 end
 
 function enemy:attack()
@@ -198,12 +201,13 @@ function enemy:throw_flames()
   local prefix = self:get_name() .. "_flame_"
   local nb_to_create = (1 + nb_floors_destroyed) * 5
 
-  function repeat_throw_flame()
+  -- One timer repeated until all flames are thrown.
+  local function repeat_throw_flame()
 
     if vulnerable then
       -- Got immobilized while shooting flames.
       attacking = false
-      return
+      return false
     end
 
     sol.audio.play_sound("lamp")
@@ -218,16 +222,18 @@ function enemy:throw_flames()
     }
     nb_to_create = nb_to_create - 1
     if nb_to_create > 0 then
-      sol.timer.start(self:get_map(), 150, repeat_throw_flame)
-    else
-      attacking = false
-      attack_scheduled = false
-      self:restart()
+      return true
     end
+    attacking = false
+    attack_scheduled = false
+    self:restart()
+    return false
   end
   self:stop_movement()
   self:get_sprite():set_direction(0)
-  repeat_throw_flame()
+  if repeat_throw_flame() then
+    sol.timer.start(self:get_map(), 150, repeat_throw_flame)
+  end
 end
 
 function enemy:throw_bats()
@@ -246,7 +252,8 @@ function enemy:throw_bats()
   local prefix = self:get_name() .. "_bat_"
   local nb_to_create = 9
 
-  function repeat_throw_bat()
+  -- One timer repeated until all bats are thrown.
+  local function repeat_throw_bat()
 
     sol.audio.play_sound("lamp")
     nb_bats_created = nb_bats_created + 1
@@ -267,20 +274,22 @@ function enemy:throw_bats()
 
     nb_to_create = nb_to_create - 1
     if nb_to_create > 0 then
-      sol.timer.start(self:get_map(), 233, repeat_throw_bat)
+      return true
+    end
+    attacking = false
+    attack_scheduled = false
+    if not vulnerable then
+      self:restart()
     else
-      attacking = false
-      attack_scheduled = false
-      if not vulnerable then
-	self:restart()
-      else
-	cancel_next_attack = false
-      end
+      cancel_next_attack = false
     end
+    return false
   end
   self:stop_movement()
   self:get_sprite():set_direction(0)
-  repeat_throw_bat()
+  if repeat_throw_bat() then
+    sol.timer.start(self:get_map(), 233, repeat_throw_bat)
+  end
 end
 
 function enemy:schedule_attack()
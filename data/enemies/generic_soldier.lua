@@ -20,6 +20,11 @@
 -- The parameter of set_properties() is a table.
 -- Its values are all optional except main_sprite
 -- and sword_sprite.
+
+local hero_proximity = require("enemies/lib/hero_proximity")
+local movement_pool = require("enemies/lib/movement_pool")
+local palettes = require("enemies/lib/palettes")
+
 return function(enemy)
 
   local properties = {}
@@ -57,13 +62,18 @@ return function(enemy)
     self:set_life(properties.life)
     self:set_damage(properties.damage)
     self:set_hurt_style(properties.hurt_style)
-    sword_sprite = self:create_sprite(properties.sword_sprite)
-    main_sprite = self:create_sprite(properties.main_sprite)
+    sword_sprite = palettes.create_sprite(self, properties.sword_sprite)
+    main_sprite = palettes.create_sprite(self, properties.main_sprite)
     self:set_size(16, 16)
     self:set_origin(8, 13)
 
     self:set_invincible_sprite(sword_sprite)
     self:set_attack_consequence_sprite(sword_sprite, "sword", "custom")
+
+    hero_proximity.watch(self, {
+      delay = 1000,
+      on_changed = function() self:check_hero() end,
+    })
   end
 
   function enemy:on_restarted()
@@ -80,11 +90,7 @@ return function(enemy)
 
   function enemy:check_hero()
 
-    local hero = self:get_map():get_entity("hero")
-    local _, _, layer = self:get_position()
-    local _, _, hero_layer = hero:get_position()
-    local near_hero = layer == hero_layer
-      and self:get_distance(hero) < 100
+    local near_hero = hero_proximity.is_hero_near(self)
 
     if near_hero and not going_hero then
       if properties.play_hero_seen_sound then
@@ -94,8 +100,6 @@ return function(enemy)
     elseif not near_hero and going_hero then
       self:go_random()
     end
-    sol.timer.stop_all(self)
-    sol.timer.start(self, 1000, function() self:check_hero() end)
   end
 
   function enemy:on_movement_changed(movement)
@@ -111,6 +115,7 @@ return function(enemy)
 
     if being_pushed then
       self:go_hero()
+      self:check_hero()
     end
   end
 
@@ -118,6 +123,7 @@ return function(enemy)
 
     if being_pushed then
       self:go_hero()
+      self:check_hero()
     end
   end
 
@@ -138,7 +144,7 @@ return function(enemy)
   end
 
   function enemy:go_random()
-    local movement = sol.movement.create("random_path")
+    local movement = movement_pool.get(self, "random_path")
     movement:set_speed(properties.normal_speed)
     movement:start(self)
     being_pushed = false
@@ -146,7 +152,7 @@ return function(enemy)
   end
 
   function enemy:go_hero()
-    local movement = sol.movement.create("target")
+    local movement = movement_pool.get(self, "target")
     movement:set_speed(properties.faster_speed)
     movement:start(self)
     being_pushed = false
@@ -24,6 +24,10 @@
 
 -- The parameter of set_properties() is a table.
 -- Its values are all optional except the sprite.
+
+local hero_proximity = require("enemies/lib/hero_proximity")
+local movement_pool = require("enemies/lib/movement_pool")
+
 return function(enemy)
 
   local properties = {}
@@ -72,6 +76,11 @@ return function(enemy)
     self:set_push_hero_on_sword(properties.push_hero_on_sword)
     self:set_size(16, 16)
     self:set_origin(8, 13)
+
+    hero_proximity.watch(self, {
+      delay = 100,
+      on_changed = function() self:check_hero() end,
+    })
   end
 
   function enemy:on_movement_changed(movement)
@@ -96,31 +105,24 @@ return function(enemy)
 
   function enemy:check_hero()
 
-    local hero = self:get_map():get_entity("hero")
-    local _, _, layer = self:get_position()
-    local _, _, hero_layer = hero:get_position()
-    local near_hero = layer == hero_layer
-      and self:get_distance(hero) < 100
+    local near_hero = hero_proximity.is_hero_near(self)
 
     if near_hero and not going_hero then
       self:go_hero()
     elseif not near_hero and going_hero then
       self:go_random()
     end
-
-    sol.timer.stop_all(self)
-    sol.timer.start(self, 100, function() self:check_hero() end)
   end
 
   function enemy:go_random()
-    local m = properties.movement_create()
+    local m = movement_pool.get(self, "random", properties.movement_create)
     m:set_speed(properties.normal_speed)
     m:start(self)
     going_hero = false
   end
 
   function enemy:go_hero()
-    local m = sol.movement.create("target")
+    local m = movement_pool.get(self, "target")
     m:set_speed(properties.faster_speed)
     m:start(self)
     going_hero = true
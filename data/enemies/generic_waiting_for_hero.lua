@@ -27,6 +27,10 @@
 
 -- The parameter of set_properties() is a table.
 -- Its values are all optional except the sprites.
+
+local hero_proximity = require("enemies/lib/hero_proximity")
+local movement_pool = require("enemies/lib/movement_pool")
+
 return function(enemy)
 
   local properties = {}
@@ -94,9 +98,15 @@ return function(enemy)
         enemy:set_default_attack_consequences()
         awaken = true
         enemy:go_hero()
+        enemy:check_hero()
       end
     end
     sprite:set_animation(properties.asleep_animation)
+
+    hero_proximity.watch(self, {
+      delay = 1000,
+      on_changed = function() self:check_hero() end,
+    })
   end
 
   function enemy:on_movement_changed(movement)
@@ -126,11 +136,7 @@ return function(enemy)
 
   function enemy:check_hero()
 
-    local hero = self:get_map():get_entity("hero")
-    local _, _, layer = self:get_position()
-    local _, _, hero_layer = hero:get_position()
-    local near_hero = layer == hero_layer
-      and self:get_distance(hero) < 100
+    local near_hero = hero_proximity.is_hero_near(self)
 
     if awaken then
       if near_hero and not going_hero then
@@ -141,9 +147,6 @@ return function(enemy)
     elseif not awaken and near_hero then
       self:wake_up()
     end
-
-    sol.timer.stop_all(self)
-    sol.timer.start(self, 1000, function() self:check_hero() end)
   end
 
   function enemy:wake_up()
@@ -158,7 +161,7 @@ return function(enemy)
 
   function enemy:go_random()
 
-    local m = sol.movement.create("random")
+    local m = movement_pool.get(self, "random")
     m:set_speed(properties.normal_speed)
     m:start(self)
     going_hero = false
@@ -166,7 +169,7 @@ return function(enemy)
 
   function enemy:go_hero()
 
-    local m = sol.movement.create("target")
+    local m = movement_pool.get(self, "target")
     m:set_speed(properties.faster_speed)
     m:start(self)
     going_hero = true
@@ -0,0 +1,150 @@
+-- Tells enemies when the hero comes near them or goes away.
+--
+-- Instead of each enemy running its own timer to measure its distance to
+-- the hero, one timer per map checks all enemies registered with watch(),
+-- and an enemy is only notified when its state changes.
+--
+-- Usage from an enemy script:
+--
+-- local hero_proximity = require("enemies/lib/hero_proximity")
+--
+-- function enemy:on_created()
+--   hero_proximity.watch(enemy, {
+--     distance = 100,      -- Distance to be near the hero (default 100).
+--     delay = 1000,        -- Delay between two checks (default 100).
+--     ignore_layer = true, -- Whether the hero can be near on another layer
+--                          -- (default false).
+--     on_changed = function(near_hero)
+--       -- The hero just came near or went away.
+--     end,
+--   })
+-- end
+--
+-- -- Checks now, for example when the enemy restarts:
+-- local near_hero = hero_proximity.is_hero_near(enemy)
+--
+-- Like the timers of an enemy, the checks are suspended while the enemy
+-- is hurt, immobilized or dying, so that on_changed() never starts a
+-- movement during these states. They resume when the enemy restarts.
+-- For this, watch() chains the on_hurt(), on_immobilized(), on_dying()
+-- and on_restarted() events already defined by the enemy script.
+
+local hero_proximity = {}
+
+local tick_delay = 100
+
+-- Enemies watched on each map, and the timer state.
+local maps_info = setmetatable({}, { __mode = "k" })
+
+local function compute_near_hero(watcher, hero_x, hero_y, hero_layer)
+
+  local x, y, layer = watcher.enemy:get_position()
+  if layer ~= hero_layer and not watcher.ignore_layer then
+    return false
+  end
+
+  -- Most enemies are far: avoid the square root for them.
+  local distance = watcher.distance
+  local dx, dy = x - hero_x, y - hero_y
+  if dx > distance or dx < -distance or dy > distance or dy < -distance then
+    return false
+  end
+  return math.sqrt(dx * dx + dy * dy) < distance
+end
+
+-- Checks the enemies whose delay has elapsed.
+local function check_enemies(map_info)
+
+  local hero = map_info.map:get_hero()
+  local hero_x, hero_y, hero_layer = hero:get_position()
+  local tick = map_info.tick + 1
+  map_info.tick = tick
+
+  local watchers = map_info.watchers
+  local i = 1
+  while i <= #watchers do
+    local watcher = watchers[i]
+    local enemy = watcher.enemy
+    if not enemy:exists() then
+      -- Removed from the map.
+      table.remove(watchers, i)
+    else
+      if tick >= watcher.next_tick
+          and not watcher.suspended
+          and enemy:is_enabled() then
+        watcher.next_tick = tick + watcher.num_ticks
+        local near_hero = compute_near_hero(watcher, hero_x, hero_y, hero_layer)
+        if near_hero ~= watcher.near_hero then
+          watcher.near_hero = near_hero
+          watcher.on_changed(near_hero)
+        end
+      end
+      i = i + 1
+    end
+  end
+  return true  -- Repeat the timer.
+end
+
+local function get_map_info(map)
+
+  local map_info = maps_info[map]
+  if map_info == nil then
+    map_info = {
+      map = map,
+      tick = 0,
+      watchers = {},
+      watchers_by_enemy = setmetatable({}, { __mode = "k" }),
+    }
+    maps_info[map] = map_info
+    -- The timer stops with the map.
+    sol.timer.start(map, tick_delay, function()
+      return check_enemies(map_info)
+    end)
+  end
+  return map_info
+end
+
+-- Starts notifying an enemy when the hero comes near or goes away.
+function hero_proximity.watch(enemy, properties)
+
+  local map_info = get_map_info(enemy:get_map())
+  local watcher = {
+    enemy = enemy,
+    distance = properties.distance or 100,
+    ignore_layer = properties.ignore_layer or false,
+    num_ticks = math.max(1, math.floor((properties.delay or tick_delay) / tick_delay)),
+    on_changed = properties.on_changed,
+    near_hero = false,
+  }
+  -- Spread the checks of enemies with the same delay.
+  watcher.next_tick = map_info.tick + 1 + #map_info.watchers % watcher.num_ticks
+  map_info.watchers[#map_info.watchers + 1] = watcher
+  map_info.watchers_by_enemy[enemy] = watcher
+
+  -- Suspend the checks while the engine controls the enemy.
+  local function chain_event(event_name, suspended)
+    local previous = enemy[event_name]
+    enemy[event_name] = function(...)
+      watcher.suspended = suspended
+      if previous ~= nil then
+        return previous(...)
+      end
+    end
+  end
+  chain_event("on_hurt", true)
+  chain_event("on_immobilized", true)
+  chain_event("on_dying", true)
+  chain_event("on_restarted", false)
+end
+
+-- Returns whether the hero is near a watched enemy right now.
+function hero_proximity.is_hero_near(enemy)
+
+  local map_info = maps_info[enemy:get_map()]
+  local watcher = map_info.watchers_by_enemy[enemy]
+  local hero_x, hero_y, hero_layer = map_info.map:get_hero():get_position()
+  watcher.near_hero = compute_near_hero(watcher, hero_x, hero_y, hero_layer)
+  return watcher.near_hero
+end
+
+return hero_proximity
@@ -0,0 +1,48 @@
+-- Movements reused by an enemy instead of creating a new one each time
+-- it changes what it is doing.
+--
+-- Usage from an enemy script:
+--
+-- local movement_pool = require("enemies/lib/movement_pool")
+--
+-- function enemy:go_hero()
+--   local m = movement_pool.get(enemy, "target")
+--   m:set_speed(64)
+--   m:start(enemy)
+-- end
+--
+-- Each enemy has at most one movement of each kind. The kind is a movement
+-- type of sol.movement.create(), or any name if a function that creates
+-- the movement is given:
+-- local m = movement_pool.get(enemy, "wander", properties.movement_create)
+--
+-- Only use this for movements that are set again entirely before being
+-- started, and that never finish on their own (like "target", "random",
+-- "random_path" or "path_finding"): a finished movement is not restarted.
+
+local movement_pool = {}
+
+-- Movements of each enemy, indexed by kind.
+local pools = setmetatable({}, { __mode = "k" })
+
+function movement_pool.get(enemy, kind, create_movement)
+
+  local pool = pools[enemy]
+  if pool == nil then
+    pool = {}
+    pools[enemy] = pool
+  end
+
+  local movement = pool[kind]
+  if movement == nil then
+    if create_movement ~= nil then
+      movement = create_movement()
+    else
+      movement = sol.movement.create(kind)
+    end
+    pool[kind] = movement
+  end
+  return movement
+end
+
+return movement_pool
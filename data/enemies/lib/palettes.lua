@@ -0,0 +1,116 @@
+-- Color variants of enemy sprites drawn from a single base sheet.
+--
+-- Some enemy sprites only differ by a few colors: for example the blue
+-- knight soldier is the red one where the red colors are replaced by blue
+-- ones, with the same animations. Such variants are created from the
+-- sprite of their base sheet with the "palette" shader
+-- (shaders/palette.frag.glsl) that replaces the colors.
+-- The images of the variants are then never loaded.
+--
+-- If the engine has no shaders on sprites, or if the shader cannot be
+-- created, the sprites of the variants are used as before.
+--
+-- Usage from an enemy script:
+-- local palettes = require("enemies/lib/palettes")
+-- local sprite = palettes.create_sprite(enemy, "enemies/blue_knight_soldier")
+
+local palettes = {}
+
+local red_to_blue_soldier = {
+  { { 222, 99, 107 }, { 115, 148, 239 } },
+  { { 255, 156, 165 }, { 214, 181, 255 } },
+}
+
+local red_to_green_soldier = {
+  { { 222, 99, 107 }, { 33, 189, 90 } },
+  { { 255, 156, 165 }, { 173, 255, 82 } },
+}
+
+-- Base sprite and colors replaced of each variant.
+-- The variants have exactly the animations of their base sprite.
+local variants = {
+  ["enemies/blue_knight_soldier"] = {
+    base = "enemies/red_knight_soldier",
+    colors = {
+      { { 222, 99, 107 }, { 115, 148, 239 } },
+      { { 255, 156, 165 }, { 214, 181, 255 } },
+      { { 255, 255, 99 }, { 222, 99, 107 } },
+    },
+  },
+  ["enemies/green_knight_soldier"] = {
+    base = "enemies/red_knight_soldier",
+    colors = red_to_green_soldier,
+  },
+  ["enemies/blue_pig_soldier"] = {
+    base = "enemies/red_pig_soldier",
+    colors = red_to_blue_soldier,
+  },
+  ["enemies/green_duck_soldier"] = {
+    base = "enemies/red_duck_soldier",
+    colors = red_to_green_soldier,
+  },
+  ["enemies/blue_flame"] = {
+    base = "enemies/red_flame",
+    colors = {
+      { { 200, 48, 16 }, { 74, 82, 214 } },
+      { { 248, 112, 48 }, { 123, 148, 255 } },
+      { { 248, 200, 32 }, { 140, 214, 255 } },
+      { { 248, 248, 248 }, { 255, 255, 255 } },
+    },
+  },
+}
+
+-- Swords are in the same images as their soldier.
+for _, color in ipairs({ "blue_knight", "green_knight", "blue_pig", "green_duck" }) do
+  local variant = variants["enemies/" .. color .. "_soldier"]
+  variants["enemies/" .. color .. "_soldier_sword"] = {
+    base = variant.base .. "_sword",
+    colors = variant.colors,
+  }
+end
+
+local shaders = {}  -- Shader of each variant, or false if it failed.
+
+-- Returns the shader that draws a variant, or nil if it cannot be created.
+local function get_shader(sprite_id, variant)
+
+  local shader = shaders[sprite_id]
+  if shader == nil then
+    local success
+    success, shader = pcall(sol.shader.create, "palette")
+    if success and shader ~= nil then
+      local palette = sol.surface.create(16, 2)
+      for i, color in ipairs(variant.colors) do
+        palette:fill_color(color[1], i - 1, 0, 1, 1)
+        palette:fill_color(color[2], i - 1, 1, 1, 1)
+      end
+      shader:set_uniform("palette", palette)
+      shader:set_uniform("palette_size", #variant.colors)
+    else
+      shader = false
+    end
+    shaders[sprite_id] = shader
+  end
+  return shader or nil
+end
+
+-- Creates a sprite of an enemy, from the base sheet of its variant
+-- if possible.
+function palettes.create_sprite(enemy, sprite_id)
+
+  local variant = variants[sprite_id]
+  if variant ~= nil and sol.shader ~= nil then
+    local shader = get_shader(sprite_id, variant)
+    if shader ~= nil then
+      local sprite = enemy:create_sprite(variant.base)
+      if sprite.set_shader ~= nil then
+        sprite:set_shader(shader)
+        return sprite
+      end
+      enemy:remove_sprite(sprite)
+    end
+  end
+  return enemy:create_sprite(sprite_id)
+end
+
+return palettes
@@ -0,0 +1,158 @@
+-- Groups of map entities by name prefix, for map scripts.
+--
+-- map:get_entities(prefix) and map:has_entities(prefix) scan all entities
+-- of the map at each call. Map scripts that call them in loops or in
+-- the events of sensors and enemies can instead use the same functions
+-- with "group" in their name: each group is built the first time it is
+-- requested and then kept up to date.
+--
+-- for enemy in map:get_group_entities("hidden_enemy") do
+--   enemy.on_dead = hidden_enemy_dead
+-- end
+-- if not map:has_group_entities("hidden_enemy") then ... end
+--
+-- The named entities of the map are gathered in one pass the first time a
+-- group is requested. Entities created later with map:create_*()
+-- are added to the existing groups. Entities removed from the map are
+-- dropped from their groups the next time the groups are used.
+--
+-- map:get_entity(name) does not need this: the engine already indexes
+-- entities by name.
+--
+-- Usage:
+-- local entity_registry = require("entity_registry")
+-- entity_registry.initialize()
+
+local entity_registry = {}
+
+-- Named entities and groups of each map.
+local registries = setmetatable({}, { __mode = "k" })
+
+local function has_prefix(name, prefix)
+  return name:sub(1, #prefix) == prefix
+end
+
+-- Removes from an array the entities that no longer exist.
+local function prune(entities)
+
+  local count = 0
+  for i = 1, #entities do
+    local entity = entities[i]
+    entities[i] = nil
+    if entity:exists() then
+      count = count + 1
+      entities[count] = entity
+    end
+  end
+end
+
+-- Returns the registry of a map, gathering its named entities
+-- the first time.
+local function get_registry(map)
+
+  local registry = registries[map]
+  if registry == nil then
+    registry = {
+      entities = {},  -- Named entities.
+      names = {},     -- Name of each entity, indexed by entity.
+      groups = {},    -- Entities of each prefix requested, indexed by prefix.
+    }
+    for entity in map:get_entities() do
+      local name = entity:get_name()
+      if name ~= nil then
+        registry.entities[#registry.entities + 1] = entity
+        registry.names[entity] = name
+      end
+    end
+    registries[map] = registry
+  end
+  return registry
+end
+
+-- Returns the array of existing entities whose name starts with a prefix.
+local function get_group(map, prefix)
+
+  local registry = get_registry(map)
+  local group = registry.groups[prefix]
+  if group == nil then
+    prune(registry.entities)
+    group = {}
+    for _, entity in ipairs(registry.entities) do
+      if has_prefix(registry.names[entity], prefix) then
+        group[#group + 1] = entity
+      end
+    end
+    registry.groups[prefix] = group
+  else
+    prune(group)
+  end
+  return group
+end
+
+-- Adds an entity just created to the registry of its map, if any.
+local function add_entity(map, entity)
+
+  local registry = registries[map]
+  local name = entity ~= nil and entity:get_name()
+  if registry == nil or not name then
+    -- The entity will be found if the registry gets built.
+    return
+  end
+
+  registry.entities[#registry.entities + 1] = entity
+  registry.names[entity] = name
+  for prefix, group in pairs(registry.groups) do
+    if has_prefix(name, prefix) then
+      group[#group + 1] = entity
+    end
+  end
+end
+
+-- Adds the group functions to maps.
+function entity_registry.initialize()
+
+  local map_meta = sol.main.get_metatable("map")
+
+  -- Returns an iterator over the entities whose name starts with a prefix.
+  -- Like map:get_entities(), entities removed during the loop are still
+  -- iterated.
+  function map_meta:get_group_entities(prefix)
+
+    local entities = {}
+    for i, entity in ipairs(get_group(self, prefix)) do
+      entities[i] = entity
+    end
+    local index = 0
+    return function()
+      index = index + 1
+      return entities[index]
+    end
+  end
+
+  -- Returns the number of entities whose name starts with a prefix.
+  function map_meta:get_group_entities_count(prefix)
+    return #get_group(self, prefix)
+  end
+
+  -- Returns whether there is an entity whose name starts with a prefix.
+  function map_meta:has_group_entities(prefix)
+    return get_group(self, prefix)[1] ~= nil
+  end
+
+  -- Keep the groups up to date when entities are created.
+  local create_functions = {}
+  for key, value in pairs(map_meta) do
+    if type(key) == "string" and key:match("^create_") and type(value) == "function" then
+      create_functions[key] = value
+    end
+  end
+  for key, create in pairs(create_functions) do
+    map_meta[key] = function(map, ...)
+      local entity = create(map, ...)
+      add_entity(map, entity)
+      return entity
+    end
+  end
+end
+
+return entity_registry
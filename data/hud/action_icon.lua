@@ -1,5 +1,6 @@
 -- The icon that shows what the action command does.
 
+local surface_cache = require("surface_cache")
 local action_icon = {}
 
 function action_icon:new(game)
@@ -17,7 +18,7 @@ function action_icon:initialize(game)
 
   self.game = game
   self.surface = sol.surface.create(72, 24)
-  self.icons_img = sol.surface.create("action_icon.png", true)
+  self.icons_img = surface_cache.get(self, "action_icon.png", true)
   self.icon_region_y = nil
   self.icon_flip_sprite = sol.sprite.create("hud/action_icon_flip")
   self.is_flipping = false
@@ -66,6 +67,11 @@ function action_icon:compute_icon_region_y()
   end
 end
 
+-- Called by the HUD when the action effect may have changed.
+function action_icon:on_hud_changed()
+  self:check()
+end
+
 function action_icon:check()
 
   local need_rebuild = false
@@ -93,11 +99,6 @@ function action_icon:check()
   if need_rebuild then
     self:rebuild_surface()
   end
-
-  -- Schedule the next check.
-  sol.timer.start(self.game, 50, function()
-    self:check()
-  end)
 end
 
 function action_icon:rebuild_surface()
@@ -118,6 +119,10 @@ function action_icon:set_dst_position(x, y)
   self.dst_y = y
 end
 
+function action_icon:is_visible()
+  return true
+end
+
 function action_icon:on_draw(dst_surface)
 
   local x, y = self.dst_x, self.dst_y
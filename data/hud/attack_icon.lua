@@ -1,5 +1,6 @@
 -- The icon that shows what the attack command does.
 
+local surface_cache = require("surface_cache")
 local attack_icon = {}
 
 function attack_icon:new(game)
@@ -17,7 +18,7 @@ function attack_icon:initialize(game)
 
   self.game = game
   self.surface = sol.surface.create(72, 24)
-  self.icons_img = sol.surface.create("sword_icon.png", true)
+  self.icons_img = surface_cache.get(self, "sword_icon.png", true)
   self.icon_region_y = nil
   self.icon_flip_sprite = sol.sprite.create("hud/sword_icon_flip")
   self.is_flipping = false
@@ -65,6 +66,11 @@ function attack_icon:compute_icon_region_y()
   end
 end
 
+-- Called by the HUD when the attack effect may have changed.
+function attack_icon:on_hud_changed()
+  self:check()
+end
+
 function attack_icon:check()
 
   local need_rebuild = false
@@ -99,11 +105,6 @@ function attack_icon:check()
   if need_rebuild then
     self:rebuild_surface()
   end
-
-  -- Schedule the next check.
-  sol.timer.start(self.game, 50, function()
-    self:check()
-  end)
 end
 
 function attack_icon:rebuild_surface()
@@ -124,6 +125,10 @@ function attack_icon:set_dst_position(x, y)
   self.dst_y = y
 end
 
+function attack_icon:is_visible()
+  return true
+end
+
 function attack_icon:on_draw(dst_surface)
 
   local x, y = self.dst_x, self.dst_y
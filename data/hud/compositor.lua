@@ -0,0 +1,172 @@
+-- Draws all HUD elements on the screen with a single surface.
+-- Each element still draws itself on its own small surface when it changes.
+-- The compositor then copies the regions that have changed to a surface
+-- of the size of the quest, and only this surface is drawn on the screen.
+
+local compositor = {}
+
+function compositor:new(game, elements)
+
+  local object = {}
+  setmetatable(object, self)
+  self.__index = self
+
+  object:initialize(game, elements)
+
+  return object
+end
+
+function compositor:initialize(game, elements)
+
+  local width, height = sol.video.get_quest_size()
+  self.game = game
+  self.elements = elements
+  self.width = width
+  self.height = height
+  self.surface = sol.surface.create(width, height)
+
+  -- A transparent surface that erases what it is drawn on.
+  self.clear_surface = sol.surface.create(width, height)
+  self.clear_surface:set_blend_mode("none")
+
+  -- Where each element is currently drawn on self.surface.
+  self.regions = {}
+
+  -- Rectangles of self.surface to redraw, as arrays of { x, y, width, height }.
+  self.dirty_rectangles = {}
+
+  for _, element in ipairs(elements) do
+    local element_width, element_height = element.surface:get_size()
+    self.regions[element] = {
+      visible = false,
+      x = 0,
+      y = 0,
+      width = element_width,
+      height = element_height,
+      opacity = 255,
+      changed = true,
+    }
+
+    -- Know when the element redraws its own surface.
+    local rebuild_surface = element.rebuild_surface
+    local regions = self.regions
+    element.rebuild_surface = function(...)
+      rebuild_surface(...)
+      regions[element].changed = true
+    end
+  end
+end
+
+function compositor:on_started()
+
+  -- Elements like the hearts have work to do when the HUD becomes
+  -- enabled again.
+  for _, element in ipairs(self.elements) do
+    if element.on_started ~= nil then
+      element:on_started()
+    end
+  end
+end
+
+function compositor:on_finished()
+
+  -- Like elements that are menus, stop the timers attached to them.
+  for _, element in ipairs(self.elements) do
+    sol.timer.stop_all(element)
+  end
+end
+
+function compositor:add_dirty_rectangle(x, y, width, height)
+
+  local dirty_rectangles = self.dirty_rectangles
+  dirty_rectangles[#dirty_rectangles + 1] = { x, y, width, height }
+end
+
+-- Returns the intersection of two rectangles, or nil.
+local function intersect(x1, y1, width1, height1, x2, y2, width2, height2)
+
+  local x = math.max(x1, x2)
+  local y = math.max(y1, y2)
+  local width = math.min(x1 + width1, x2 + width2) - x
+  local height = math.min(y1 + height1, y2 + height2) - y
+  if width <= 0 or height <= 0 then
+    return nil
+  end
+  return x, y, width, height
+end
+
+-- Detects the elements that have changed since the last frame and marks the
+-- rectangles they used to cover and they now cover.
+function compositor:find_dirty_rectangles()
+
+  for _, element in ipairs(self.elements) do
+
+    local region = self.regions[element]
+    local visible = element:is_visible()
+    local x, y = element.dst_x, element.dst_y
+    if x < 0 then
+      x = self.width + x
+    end
+    if y < 0 then
+      y = self.height + y
+    end
+    local opacity = element.surface:get_opacity()
+
+    if region.changed
+        or visible ~= region.visible
+        or x ~= region.x
+        or y ~= region.y
+        or opacity ~= region.opacity then
+
+      if region.visible then
+        self:add_dirty_rectangle(region.x, region.y, region.width, region.height)
+      end
+      region.visible = visible
+      region.x = x
+      region.y = y
+      region.opacity = opacity
+      region.changed = false
+      if visible then
+        self:add_dirty_rectangle(x, y, region.width, region.height)
+      end
+    end
+  end
+end
+
+-- Clears a rectangle of the surface and draws again the part of each
+-- element that is in it, in the HUD order.
+function compositor:redraw_rectangle(x, y, width, height)
+
+  self.clear_surface:draw_region(x, y, width, height, self.surface, x, y)
+
+  for _, element in ipairs(self.elements) do
+    local region = self.regions[element]
+    if region.visible then
+      local part_x, part_y, part_width, part_height = intersect(
+          x, y, width, height,
+          region.x, region.y, region.width, region.height)
+      if part_x ~= nil then
+        element.surface:draw_region(
+            part_x - region.x, part_y - region.y, part_width, part_height,
+            self.surface, part_x, part_y)
+      end
+    end
+  end
+end
+
+function compositor:on_draw(dst_surface)
+
+  self:find_dirty_rectangles()
+
+  local dirty_rectangles = self.dirty_rectangles
+  if #dirty_rectangles > 0 then
+    for i, rectangle in ipairs(dirty_rectangles) do
+      self:redraw_rectangle(rectangle[1], rectangle[2], rectangle[3], rectangle[4])
+      dirty_rectangles[i] = nil
+    end
+  end
+
+  self.surface:draw(dst_surface)
+end
+
+return compositor
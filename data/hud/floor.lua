@@ -1,5 +1,6 @@
 -- The floor view shown when entering a map that has a floor.
 
+local surface_cache = require("surface_cache")
 local floor_view = {}
 
 function floor_view:new(game)
@@ -18,7 +19,7 @@ function floor_view:initialize(game)
   self.game = game
   self.visible = false
   self.surface = sol.surface.create(32, 85)
-  self.floors_img = sol.surface.create("floors.png", true)  -- Language-specific image
+  self.floors_img = surface_cache.get(self, "floors.png", true)  -- Language-specific image
   self.floor = nil
 end
 
@@ -100,9 +101,13 @@ function floor_view:set_dst_position(x, y)
   self.dst_y = y
 end
 
+function floor_view:is_visible()
+  return self.visible
+end
+
 function floor_view:on_draw(dst_surface)
 
-  if self.visible then
+  if self:is_visible() then
     local x, y = self.dst_x, self.dst_y
     local width, height = dst_surface:get_size()
     if x < 0 then
@@ -1,5 +1,6 @@
 -- Hearts view used in game screen and in the savegames selection screen.
 
+local surface_cache = require("surface_cache")
 local hearts = {}
 
 function hearts:new(game)
@@ -22,7 +23,7 @@ function hearts:initialize(game)
   self.empty_heart_sprite = sol.sprite.create("hud/empty_heart")
   self.nb_max_hearts_displayed = game:get_max_life() / 4
   self.nb_current_hearts_displayed = game:get_life()
-  self.all_hearts_img = sol.surface.create("hud/hearts.png")
+  self.all_hearts_img = surface_cache.get(self, "hud/hearts.png")
 end
 
 function hearts:on_started()
@@ -30,13 +31,22 @@ function hearts:on_started()
   -- This function is called when the HUD starts or
   -- was disabled and gets enabled again.
   -- Unlike other HUD elements, the timers were canceled because they
-  -- are attached to the menu and not to the game
+  -- are attached to the hearts and not to the game
   -- (this is because the hearts are also used in the savegame menu).
   self.danger_sound_timer = nil
+  self.check_timer = nil
   self:check()
   self:rebuild_surface()
 end
 
+-- Called by the HUD when the life may have changed.
+function hearts:on_hud_changed()
+
+  if self.check_timer == nil and self.game:is_hud_enabled() then
+    self:check()
+  end
+end
+
 -- Checks whether the view displays the correct info
 -- and updates it if necessary.
 function hearts:check()
@@ -98,10 +108,15 @@ function hearts:check()
     self:rebuild_surface()
   end
 
-  -- Schedule the next check.
-  sol.timer.start(self, 50, function()
-    self:check()
-  end)
+  -- Schedule the next check while the hearts are changing
+  -- or while the danger animation is playing.
+  self.check_timer = nil
+  if self.nb_current_hearts_displayed ~= self.game:get_life()
+      or self.empty_heart_sprite:get_animation() == "danger" then
+    self.check_timer = sol.timer.start(self, 50, function()
+      self:check()
+    end)
+  end
 end
 
 function hearts:repeat_danger_sound()
@@ -146,6 +161,10 @@ function hearts:set_dst_position(x, y)
   self.dst_y = y
 end
 
+function hearts:is_visible()
+  return true
+end
+
 function hearts:on_draw(dst_surface)
 
   local x, y = self.dst_x, self.dst_y
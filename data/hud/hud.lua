@@ -1,5 +1,341 @@
+-- Values shown by the HUD, with the HUD elements that show them.
+-- Quest scripts that change these values notify the HUD immediately
+-- (see the hooks below), and so do the engine events that follow the
+-- other changes (hero states, shops, doors and item events).
+-- The engine changes the command effects without any event: only these
+-- ones are marked as polled, and a single timer compares them regularly
+-- with the cached ones.
+-- Only the elements whose values have changed are updated.
+local watched_properties = {
+  {
+    name = "life",
+    elements = { "hearts" },
+    get = function(game) return game:get_life() end,
+  },
+  {
+    name = "max_life",
+    elements = { "hearts" },
+    get = function(game) return game:get_max_life() end,
+  },
+  {
+    name = "magic",
+    elements = { "magic_bar" },
+    get = function(game) return game:get_magic() end,
+  },
+  {
+    name = "max_magic",
+    elements = { "magic_bar" },
+    get = function(game) return game:get_max_magic() end,
+  },
+  {
+    name = "money",
+    elements = { "rupees" },
+    get = function(game) return game:get_money() end,
+  },
+  {
+    name = "max_money",
+    elements = { "rupees" },
+    get = function(game) return game:get_max_money() end,
+  },
+  {
+    name = "rupee_bag",
+    item_event = true,
+    elements = { "rupees" },
+    get = function(game) return game:get_item("rupee_bag"):get_variant() end,
+  },
+  {
+    name = "small_keys",
+    elements = { "small_keys" },
+    get = function(game)
+      return game:are_small_keys_enabled() and game:get_num_small_keys()
+    end,
+  },
+  {
+    name = "item_1",
+    elements = { "item_icon_1" },
+    get = function(game) return game:get_item_assigned(1) end,
+  },
+  {
+    name = "item_1_variant",
+    item_event = true,
+    elements = { "item_icon_1" },
+    get = function(game)
+      local item = game:get_item_assigned(1)
+      return item ~= nil and item:get_variant()
+    end,
+  },
+  {
+    name = "item_1_amount",
+    elements = { "item_icon_1" },
+    get = function(game)
+      local item = game:get_item_assigned(1)
+      return item ~= nil and item:has_amount() and item:get_amount()
+    end,
+  },
+  {
+    name = "item_1_max_amount",
+    elements = { "item_icon_1" },
+    get = function(game)
+      local item = game:get_item_assigned(1)
+      return item ~= nil and item:has_amount() and item:get_max_amount()
+    end,
+  },
+  {
+    name = "item_2",
+    elements = { "item_icon_2" },
+    get = function(game) return game:get_item_assigned(2) end,
+  },
+  {
+    name = "item_2_variant",
+    item_event = true,
+    elements = { "item_icon_2" },
+    get = function(game)
+      local item = game:get_item_assigned(2)
+      return item ~= nil and item:get_variant()
+    end,
+  },
+  {
+    name = "item_2_amount",
+    elements = { "item_icon_2" },
+    get = function(game)
+      local item = game:get_item_assigned(2)
+      return item ~= nil and item:has_amount() and item:get_amount()
+    end,
+  },
+  {
+    name = "item_2_max_amount",
+    elements = { "item_icon_2" },
+    get = function(game)
+      local item = game:get_item_assigned(2)
+      return item ~= nil and item:has_amount() and item:get_max_amount()
+    end,
+  },
+  {
+    name = "sword",
+    elements = { "attack_icon" },
+    get = function(game) return game:get_ability("sword") end,
+  },
+  {
+    name = "action_effect",
+    polled = true,
+    elements = { "action_icon" },
+    get = function(game)
+      return game.hud.custom_command_effects["action"] or game:get_command_effect("action")
+    end,
+  },
+  {
+    name = "attack_effect",
+    polled = true,
+    elements = { "attack_icon" },
+    get = function(game)
+      return game.hud.custom_command_effects["attack"] or game:get_command_effect("attack")
+    end,
+  },
+  {
+    name = "dialog",
+    elements = { "attack_icon" },
+    layout = true,
+    get = function(game) return game:is_dialog_enabled() end,
+  },
+  {
+    name = "suspended",
+    elements = { "hearts" },
+    layout = true,
+    get = function(game) return game:is_suspended() end,
+  },
+  {
+    -- Notified when the hero or the camera moves.
+    name = "hero_below_icons",
+    elements = {},
+    layout = true,
+    get = function(game)
+      local map = game:get_map()
+      if map == nil then
+        return false
+      end
+      local hero_x, hero_y = map:get_hero():get_position()
+      local camera_x, camera_y = map:get_camera():get_position()
+      return hero_x - camera_x < 88 and hero_y - camera_y < 80
+    end,
+  },
+}
+
+-- The item events are only hooked when the list of items is known.
+local has_item_events = sol.main.get_resource_ids ~= nil
+
+local watched_properties_by_name = {}
+local polled_properties = {}
+for _, property in ipairs(watched_properties) do
+  watched_properties_by_name[property.name] = property
+  if property.polled or (property.item_event and not has_item_events) then
+    polled_properties[#polled_properties + 1] = property
+  end
+end
+
+-- Game methods that change values watched by the HUD.
+local notifying_game_methods = {
+  set_life = "life",
+  add_life = "life",
+  remove_life = "life",
+  set_max_life = "max_life",
+  set_magic = "magic",
+  add_magic = "magic",
+  remove_magic = "magic",
+  set_max_magic = "max_magic",
+  set_money = "money",
+  add_money = "money",
+  remove_money = "money",
+  set_max_money = "max_money",
+  add_small_key = "small_keys",
+  remove_small_key = "small_keys",
+}
+
+-- Item methods that change values watched by the HUD.
+local notifying_item_methods = {
+  "set_variant",
+  "set_amount",
+  "add_amount",
+  "remove_amount",
+  "set_max_amount",
+}
+
+-- Item events that follow changes of variants and amounts.
+local item_events = {
+  "on_variant_changed",
+  "on_amount_changed",
+}
+
+local function notify_item_changed(item)
+
+  local game = item:get_game()
+  if game.hud_notify ~= nil then
+    game:hud_notify("rupee_bag")
+    game:hud_notify("item_1_variant")
+    game:hud_notify("item_1_amount")
+    game:hud_notify("item_1_max_amount")
+    game:hud_notify("item_2_variant")
+    game:hud_notify("item_2_amount")
+    game:hud_notify("item_2_max_amount")
+  end
+end
+
+-- Notify the HUD of changes of items through the Lua API.
+local item_meta = sol.main.get_metatable("item")
+for _, method_name in ipairs(notifying_item_methods) do
+  local method = item_meta[method_name]
+  item_meta[method_name] = function(item, ...)
+    method(item, ...)
+    notify_item_changed(item)
+  end
+end
+
+-- Notify the HUD when the engine changes items, like when the hero picks
+-- a treasure. Item scripts define these events themselves, so they are
+-- chained on each item instead of the metatable.
+local function hook_item_events(game)
+
+  for _, item_id in ipairs(sol.main.get_resource_ids("item")) do
+    local item = game:get_item(item_id)
+    for _, event_name in ipairs(item_events) do
+      local event = item[event_name]
+      item[event_name] = function(self, ...)
+        if event ~= nil then
+          event(self, ...)
+        end
+        notify_item_changed(self)
+      end
+    end
+  end
+end
+
+-- Notify the HUD when the hero changes state, since the engine removes
+-- life in the hurt, falling, plunging and drowning states.
+local hero_meta = sol.main.get_metatable("hero")
+function hero_meta:on_state_changed()
+
+  local game = self:get_game()
+  if game.hud_notify ~= nil then
+    game:hud_notify("life")
+  end
+end
+
+-- Notify the HUD when the hero buys something in a shop.
+local shop_treasure_meta = sol.main.get_metatable("shop_treasure")
+function shop_treasure_meta:on_bought()
+
+  local game = self:get_game()
+  if game.hud_notify ~= nil then
+    game:hud_notify("money")
+  end
+end
+
+-- Notify the HUD when a door opens, since the ones that need a small key
+-- use it. Map scripts define this event on some doors, so it is chained
+-- on each door when the map starts.
+local function hook_door_events(map)
+
+  for door in map:get_entities_by_type("door") do
+    local on_opened = door.on_opened
+    function door:on_opened(...)
+      if on_opened ~= nil then
+        on_opened(self, ...)
+      end
+      local game = self:get_game()
+      if game.hud_notify ~= nil then
+        game:hud_notify("small_keys")
+      end
+    end
+  end
+end
+
+-- Notify the HUD when the hero or the camera moves, since the top-left
+-- icons become semi-transparent when the hero is below them. The layout
+-- is only checked when he enters or leaves this area.
+local function notify_position_changed(entity)
+
+  local game = entity:get_game()
+  if game.hud_notify ~= nil then
+    game:hud_notify("hero_below_icons")
+  end
+end
+hero_meta.on_position_changed = notify_position_changed
+sol.main.get_metatable("camera").on_position_changed = notify_position_changed
+
+-- Notify the HUD when the game is suspended or resumed.
+local map_meta = sol.main.get_metatable("map")
+function map_meta:on_suspended()
+
+  local game = self:get_game()
+  if game.hud_notify ~= nil then
+    game:hud_notify("suspended")
+  end
+end
+
 return function(game)
 
+  -- Wrap the game methods that change what the HUD shows.
+  for method_name, property_name in pairs(notifying_game_methods) do
+    local method = game[method_name]
+    game[method_name] = function(self, ...)
+      method(self, ...)
+      self:hud_notify(property_name)
+    end
+  end
+
+  local set_item_assigned = game.set_item_assigned
+  function game:set_item_assigned(slot, item)
+    set_item_assigned(self, slot, item)
+    self:hud_notify("item_" .. slot)
+  end
+
+  local set_ability = game.set_ability
+  function game:set_ability(ability, level)
+    set_ability(self, ability, level)
+    if ability == "sword" then
+      self:hud_notify("sword")
+    end
+  end
+
   function game:initialize_hud()
 
     -- Set up the HUD.
@@ -12,32 +348,39 @@ return function(game)
     local pause_icon_builder = require("hud/pause_icon")
     local item_icon_builder = require("hud/item_icon")
     local action_icon_builder = require("hud/action_icon")
+    local compositor_builder = require("hud/compositor")
 
     self.hud = {  -- Array for the hud elements, table for other hud info.
       showing_dialog = false,
       top_left_opacity = 255,
       custom_command_effects = {},
+      values = {},  -- Last known value of each watched property.
     }
 
     local menu = hearts_builder:new(self)
     menu:set_dst_position(-104, 6)
     self.hud[#self.hud + 1] = menu
+    self.hud.hearts = menu
 
     menu = magic_bar_builder:new(self)
     menu:set_dst_position(-104, 27)
     self.hud[#self.hud + 1] = menu
+    self.hud.magic_bar = menu
 
     menu = rupees_builder:new(self)
     menu:set_dst_position(8, -20)
     self.hud[#self.hud + 1] = menu
+    self.hud.rupees = menu
 
     menu = small_keys_builder:new(self)
     menu:set_dst_position(-36, -18)
     self.hud[#self.hud + 1] = menu
+    self.hud.small_keys = menu
 
     menu = floor_builder:new(self)
     menu:set_dst_position(5, 70)
     self.hud[#self.hud + 1] = menu
+    self.hud.floor = menu
 
     menu = pause_icon_builder:new(self)
     menu:set_dst_position(0, 7)
@@ -64,22 +407,84 @@ return function(game)
     self.hud[#self.hud + 1] = menu
     self.hud.action_icon = menu
 
+    -- The elements are not menus: a single menu draws all of them.
+    self.hud.compositor = compositor_builder:new(self, self.hud)
+
     self:set_hud_enabled(true)
 
-    self:check_hud()
+    for _, property in ipairs(watched_properties) do
+      self.hud.values[property.name] = property.get(self)
+    end
+    self:check_hud_layout()
+
+    if has_item_events and not self.hud_item_events_hooked then
+      hook_item_events(self)
+      self.hud_item_events_hooked = true
+    end
+
+    sol.timer.start(self, 50, function()
+      self:check_hud()
+      return true  -- Repeat the timer.
+    end)
   end
 
   function game:quit_hud()
 
     if self:is_hud_enabled() then
-      -- Stop all HUD menus.
+      -- Stop the HUD menu.
       self:set_hud_enabled(false)
     end
     self.hud = nil
   end
 
+  -- Updates the HUD elements that show a property.
+  local function update_hud_elements(game, property)
+
+    local hud = game.hud
+    for _, element_name in ipairs(property.elements) do
+      hud[element_name]:on_hud_changed()
+    end
+
+    if property.layout then
+      game:check_hud_layout()
+    end
+  end
+
+  -- Notifies the HUD that a watched property may have changed.
+  function game:hud_notify(property_name)
+
+    local hud = self.hud
+    if hud == nil then
+      return
+    end
+
+    local property = watched_properties_by_name[property_name]
+    local value = property.get(self)
+    if value == hud.values[property_name] then
+      return
+    end
+    hud.values[property_name] = value
+    update_hud_elements(self, property)
+  end
+
+  -- Checks the properties that the engine may have changed
+  -- without any event and updates the corresponding HUD elements.
   function game:check_hud()
 
+    local values = self.hud.values
+    for _, property in ipairs(polled_properties) do
+      local value = property.get(self)
+      if value ~= values[property.name] then
+        values[property.name] = value
+        update_hud_elements(self, property)
+      end
+    end
+  end
+
+  -- Updates the position and the opacity of icons depending
+  -- on the hero position and on the dialog box.
+  function game:check_hud_layout()
+
     local map = self:get_map()
     if map ~= nil then
       -- If the hero is below the top-left icons, make them semi-transparent.
@@ -124,14 +529,16 @@ return function(game)
         self.hud.attack_icon:set_dst_position(13, 29)
       end
     end
-
-    sol.timer.start(self, 50, function()
-      self:check_hud()
-    end)
   end
 
   function game:hud_on_map_changed(map)
 
+    -- Some values depend on the map, like the small keys.
+    hook_door_events(map)
+    self:check_hud()
+    self:hud_notify("small_keys")
+    self:hud_notify("hero_below_icons")
+
     if self:is_hud_enabled() then
       for _, menu in ipairs(self.hud) do
         if menu.on_map_changed ~= nil then
@@ -172,12 +579,10 @@ return function(game)
     if hud_enabled ~= self.hud_enabled then
       game.hud_enabled = hud_enabled
 
-      for _, menu in ipairs(self.hud) do
-        if hud_enabled then
-          sol.menu.start(self, menu)
-        else
-          sol.menu.stop(menu)
-        end
+      if hud_enabled then
+        sol.menu.start(self, self.hud.compositor)
+      else
+        sol.menu.stop(self.hud.compositor)
       end
     end
   end
@@ -196,6 +601,7 @@ return function(game)
 
     if self.hud ~= nil then
       self.hud.custom_command_effects[command] = effect
+      self:hud_notify(command .. "_effect")
     end
   end
 
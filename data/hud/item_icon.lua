@@ -1,5 +1,6 @@
 -- An icon that shows the inventory item assigned to a slot.
 
+local surface_cache = require("surface_cache")
 local item_icon = {}
 
 function item_icon:new(game, slot)
@@ -18,7 +19,7 @@ function item_icon:initialize(game, slot)
   self.game = game
   self.slot = slot
   self.surface = sol.surface.create(32, 28)
-  self.background_img = sol.surface.create("hud/item_icon_" .. slot .. ".png")
+  self.background_img = surface_cache.get(self, "hud/item_icon_" .. slot .. ".png")
   self.item_sprite = sol.sprite.create("entities/items")
   self.item_displayed = nil
   self.item_variant_displayed = 0
@@ -33,6 +34,11 @@ function item_icon:initialize(game, slot)
   self:rebuild_surface()
 end
 
+-- Called by the HUD when the item assigned to the slot may have changed.
+function item_icon:on_hud_changed()
+  self:check()
+end
+
 function item_icon:check()
 
   local need_rebuild = false
@@ -82,11 +88,6 @@ function item_icon:check()
   if need_rebuild then
     self:rebuild_surface()
   end
-
-  -- Schedule the next check.
-  sol.timer.start(self.game, 50, function()
-    self:check()
-  end)
 end
 
 function item_icon:rebuild_surface()
@@ -117,9 +118,13 @@ function item_icon:set_dst_position(x, y)
   self.dst_y = y
 end
 
+function item_icon:is_visible()
+  return not self.game:is_dialog_enabled()
+end
+
 function item_icon:on_draw(dst_surface)
 
-  if not self.game:is_dialog_enabled() then
+  if self:is_visible() then
     local x, y = self.dst_x, self.dst_y
     local width, height = dst_surface:get_size()
     if x < 0 then
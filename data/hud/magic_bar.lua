@@ -1,5 +1,6 @@
 -- The magic bar shown in the game screen.
 
+local surface_cache = require("surface_cache")
 local magic_bar = {}
 
 function magic_bar:new(game)
@@ -17,7 +18,7 @@ function magic_bar:initialize(game)
 
   self.game = game
   self.surface = sol.surface.create(88, 8)
-  self.magic_bar_img = sol.surface.create("hud/magic_bar.png")
+  self.magic_bar_img = surface_cache.get(self, "hud/magic_bar.png")
   self.container_sprite = sol.sprite.create("hud/magic_bar")
   self.magic_displayed = game:get_magic()
   self.max_magic_displayed = 0
@@ -26,6 +27,14 @@ function magic_bar:initialize(game)
   self:rebuild_surface()
 end
 
+-- Called by the HUD when the magic may have changed.
+function magic_bar:on_hud_changed()
+
+  if self.check_timer == nil then
+    self:check()
+  end
+end
+
 -- Checks whether the view displays the correct info
 -- and updates it if necessary.
 function magic_bar:check()
@@ -70,10 +79,13 @@ function magic_bar:check()
     self:rebuild_surface()
   end
 
-  -- Schedule the next check.
-  sol.timer.start(self.game, 20, function()
-    self:check()
-  end)
+  -- Schedule the next check while the bar is moving.
+  self.check_timer = nil
+  if magic ~= self.magic_displayed then
+    self.check_timer = sol.timer.start(self.game, 20, function()
+      self:check()
+    end)
+  end
 end
 
 function magic_bar:rebuild_surface()
@@ -92,10 +104,14 @@ function magic_bar:set_dst_position(x, y)
   self.dst_y = y
 end
 
+function magic_bar:is_visible()
+  -- Is there a magic bar to show?
+  return self.max_magic_displayed > 0
+end
+
 function magic_bar:on_draw(dst_surface)
 
-  -- Is there a magic bar to show?
-  if self.max_magic_displayed > 0 then
+  if self:is_visible() then
     local x, y = self.dst_x, self.dst_y
     local width, height = dst_surface:get_size()
     if x < 0 then
@@ -1,5 +1,6 @@
 -- The icon that shows what the pause command does.
 
+local surface_cache = require("surface_cache")
 local pause_icon = {}
 
 function pause_icon:new(game)
@@ -18,7 +19,7 @@ function pause_icon:initialize(game)
   self.game = game
   self.is_game_paused = false
   self.surface = sol.surface.create(72, 24)
-  self.icons_img = sol.surface.create("pause_icon.png", true)
+  self.icons_img = surface_cache.get(self, "pause_icon.png", true)
   self.icon_region_y = 24
 
   local pause_icon = self
@@ -71,9 +72,13 @@ function pause_icon:set_dst_position(x, y)
   self.dst_y = y
 end
 
+function pause_icon:is_visible()
+  return not self.game:is_dialog_enabled()
+end
+
 function pause_icon:on_draw(dst_surface)
 
-  if not self.game:is_dialog_enabled() then
+  if self:is_visible() then
     local x, y = self.dst_x, self.dst_y
     local width, height = dst_surface:get_size()
     if x < 0 then
@@ -1,5 +1,6 @@
 -- The money counter shown in the game screen.
 
+local surface_cache = require("surface_cache")
 local rupees = {}
 
 function rupees:new(game)
@@ -22,7 +23,7 @@ function rupees:initialize(game)
     horizontal_alignment = "left",
   }
   self.digits_text:set_text(game:get_money())
-  self.rupee_icons_img = sol.surface.create("hud/rupee_icon.png")
+  self.rupee_icons_img = surface_cache.get(self, "hud/rupee_icon.png")
   self.rupee_bag_displayed = self.game:get_item("rupee_bag"):get_variant()
   self.money_displayed = self.game:get_money()
 
@@ -30,6 +31,14 @@ function rupees:initialize(game)
   self:rebuild_surface()
 end
 
+-- Called by the HUD when the money may have changed.
+function rupees:on_hud_changed()
+
+  if self.check_timer == nil then
+    self:check()
+  end
+end
+
 function rupees:check()
 
   local need_rebuild = false
@@ -68,10 +77,13 @@ function rupees:check()
     self:rebuild_surface()
   end
 
-  -- Schedule the next check.
-  sol.timer.start(self.game, 40, function()
-    self:check()
-  end)
+  -- Schedule the next check while the counter is scrolling.
+  self.check_timer = nil
+  if money ~= self.money_displayed then
+    self.check_timer = sol.timer.start(self.game, 40, function()
+      self:check()
+    end)
+  end
 end
 
 function rupees:rebuild_surface()
@@ -97,6 +109,10 @@ function rupees:set_dst_position(x, y)
   self.dst_y = y
 end
 
+function rupees:is_visible()
+  return true
+end
+
 function rupees:on_draw(dst_surface)
 
   local x, y = self.dst_x, self.dst_y
@@ -1,5 +1,6 @@
 -- The small keys counter shown during dungeons or maps with small keys enabled.
 
+local surface_cache = require("surface_cache")
 local small_keys = {}
 
 function small_keys:new(game)
@@ -18,7 +19,7 @@ function small_keys:initialize(game)
   self.game = game
   self.visible = false
   self.surface = sol.surface.create(40, 8)
-  self.icon_img = sol.surface.create("hud/small_key_icon.png")
+  self.icon_img = surface_cache.get(self, "hud/small_key_icon.png")
   self.digits_text = sol.text_surface.create{
     font = "white_digits",
     horizontal_alignment = "left",
@@ -29,6 +30,11 @@ function small_keys:initialize(game)
   self:rebuild_surface()
 end
 
+-- Called by the HUD when the number of small keys may have changed.
+function small_keys:on_hud_changed()
+  self:check()
+end
+
 function small_keys:check()
 
   local need_rebuild = false
@@ -53,11 +59,6 @@ function small_keys:check()
   if need_rebuild then
     self:rebuild_surface()
   end
-
-  -- Schedule the next check.
-  sol.timer.start(self.game, 40, function()
-    self:check()
-  end)
 end
 
 function small_keys:rebuild_surface()
@@ -72,9 +73,13 @@ function small_keys:set_dst_position(x, y)
   self.dst_y = y
 end
 
+function small_keys:is_visible()
+  return self.visible
+end
+
 function small_keys:on_draw(dst_surface)
 
-  if self.visible then
+  if self:is_visible() then
     local x, y = self.dst_x, self.dst_y
     local width, height = dst_surface:get_size()
     if x < 0 then
@@ -0,0 +1,191 @@
+-- Records the game commands of the player and replays them, to reproduce
+-- exactly the same gameplay when measuring performance.
+--
+-- Usage (for example from the console):
+-- game:start_input_recording("inputs.dat")
+-- game:stop_input_recording()
+-- game:start_input_replay("inputs.dat", callback)
+--
+-- Files are in the write directory. They contain the seed of math.random()
+-- and the commands pressed and released, with the number of updates since
+-- the beginning:
+-- seed{ value = 1234 }
+-- input{ update = 120, command = "right", pressed = true }
+--
+-- The state of the commands is checked at each update of the game, so the
+-- replay is exact as long as it starts from the same situation (same map
+-- and position) as the recording. Random choices made by the engine itself
+-- (random movements) cannot be seeded from Lua.
+-- During a replay, the keyboard and joypad do not control the game.
+
+local commands = {
+  "action", "attack", "item_1", "item_2", "pause",
+  "right", "up", "left", "down",
+}
+
+local function write_inputs(file_name, seed, inputs)
+
+  local file = sol.file.open(file_name, "w")
+  file:write("seed{ value = ", seed, " }\n")
+  for _, input in ipairs(inputs) do
+    file:write(string.format("input{ update = %d, command = \"%s\", pressed = %s }\n",
+        input.update, input.command, tostring(input.pressed)))
+  end
+  file:close()
+end
+
+-- Returns the seed and the inputs of a file, or nil if it cannot be read.
+local function read_inputs(file_name)
+
+  local file = sol.file.open(file_name)
+  if file == nil then
+    return nil
+  end
+  local chunk = loadstring(file:read("*a"))
+  file:close()
+  if chunk == nil then
+    return nil
+  end
+
+  local seed, inputs = 0, {}
+  setfenv(chunk, {
+    seed = function(properties)
+      seed = properties.value
+    end,
+    input = function(properties)
+      inputs[#inputs + 1] = properties
+    end,
+  })
+  chunk()
+  return seed, inputs
+end
+
+return function(game)
+
+  local recorder = {}  -- Menu that checks the commands at each update.
+  local mode = nil     -- "recording", "replaying" or nil.
+  local file_name = nil
+  local update = 0
+  local inputs = {}
+  local next_input_index = 1
+  local pressed = {}
+  local seed = 0
+  local saved_bindings = {}
+  local replay_callback = nil
+
+  local function start(new_mode)
+
+    if mode ~= nil then
+      error("Input recording or replay already started")
+    end
+    mode = new_mode
+    update = 0
+    pressed = {}
+    sol.menu.start(game, recorder)
+  end
+
+  function recorder:on_update()
+
+    update = update + 1
+    if mode == "recording" then
+      for _, command in ipairs(commands) do
+        local is_pressed = game:is_command_pressed(command)
+        if is_pressed ~= (pressed[command] or false) then
+          pressed[command] = is_pressed
+          inputs[#inputs + 1] = { update = update, command = command, pressed = is_pressed }
+        end
+      end
+
+    elseif mode == "replaying" then
+      local input = inputs[next_input_index]
+      while input ~= nil and input.update <= update do
+        if input.pressed then
+          game:simulate_command_pressed(input.command)
+        else
+          game:simulate_command_released(input.command)
+        end
+        pressed[input.command] = input.pressed
+        next_input_index = next_input_index + 1
+        input = inputs[next_input_index]
+      end
+      if input == nil then
+        game:stop_input_replay()
+      end
+    end
+  end
+
+  function game:start_input_recording(name)
+
+    start("recording")
+    file_name = name
+    inputs = {}
+    seed = os.time()
+    math.randomseed(seed)
+  end
+
+  function game:stop_input_recording()
+
+    if mode ~= "recording" then
+      return
+    end
+    write_inputs(file_name, seed, inputs)
+    mode = nil
+    sol.menu.stop(recorder)
+  end
+
+  -- Replays a file. Returns false if it cannot be read.
+  -- The callback is called at the end of the replay.
+  function game:start_input_replay(name, callback)
+
+    local file_seed, file_inputs = read_inputs(name)
+    if file_seed == nil then
+      return false
+    end
+
+    start("replaying")
+    seed, inputs = file_seed, file_inputs
+    next_input_index = 1
+    replay_callback = callback
+    math.randomseed(seed)
+
+    -- Ignore the real keyboard and joypad.
+    for _, command in ipairs(commands) do
+      saved_bindings[command] = {
+        game:get_command_keyboard_binding(command),
+        game:get_command_joypad_binding(command),
+      }
+      game:set_command_keyboard_binding(command, nil)
+      game:set_command_joypad_binding(command, nil)
+    end
+    return true
+  end
+
+  function game:stop_input_replay()
+
+    if mode ~= "replaying" then
+      return
+    end
+    mode = nil
+    sol.menu.stop(recorder)
+
+    for command, is_pressed in pairs(pressed) do
+      if is_pressed then
+        game:simulate_command_released(command)
+      end
+    end
+    for _, command in ipairs(commands) do
+      game:set_command_keyboard_binding(command, saved_bindings[command][1])
+      game:set_command_joypad_binding(command, saved_bindings[command][2])
+    end
+
+    local callback = replay_callback
+    replay_callback = nil
+    if callback ~= nil then
+      callback()
+    end
+  end
+
+  function game:is_replaying_inputs()
+    return mode == "replaying"
+  end
+end
@@ -2,7 +2,6 @@ local item = ...
 -- Script of the Lamp
 
 item.temporary_lit_torches = {} -- List of torches that will be unlit by timers soon (FIFO).
-item.was_dark_room = false
 
 function item:on_created()
 
@@ -58,9 +57,10 @@ function item:unlight_oldest_torch()
     npc:get_sprite():set_animation("unlit")
   end
 
-  if #self.temporary_lit_torches == 0 and self.was_dark_room then
-    -- make the room dark again
-    self:get_map():set_light(0)
+  -- The torch no longer lights the room.
+  local map = self:get_map()
+  if map.remove_light_source ~= nil then
+    map:remove_light_source(npc)
   end
 end
 
@@ -78,7 +78,6 @@ end
 function item:on_map_changed()
 
   self.temporary_lit_torches = {}
-  self.was_dark_room = false
 end
 
 -- Called when the hero presses the action key in front of an NPC
@@ -105,10 +104,9 @@ function item:on_npc_collision_fire(npc)
       table.insert(self.temporary_lit_torches, npc)
 
       local map = self:get_map()
-      if map.get_light ~= nil and map:get_light() == 0 then
-        -- Light the room.
-        self.was_dark_room = true
-        map:set_light(1)
+      if map.add_light_source ~= nil then
+        -- Light the room while the torch is lit.
+        map:add_light_source(npc)
       end
     end
   end
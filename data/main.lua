@@ -1,59 +1,158 @@
 -- Main script of the quest.
 
-local console = require("console")
-local quest_manager = require("quest_manager")
+-- If the other scripts are precompiled to LuaJIT bytecode
+-- (see ZSDX_BYTECODE in CMakeLists.txt), check that the engine uses
+-- the same LuaJIT version and GC64 mode before loading them.
+-- This script itself is never precompiled so that it can tell why.
+local function get_bytecode_error()
+
+  local chunk = sol.main.load_file("bytecode_manifest.dat")
+  if chunk == nil then
+    return nil  -- Text scripts.
+  end
 
-local debug_enabled = false
+  local version, gc64 = nil, nil
+  setfenv(chunk, {
+    luajit = function(properties)
+      version = properties.version
+      gc64 = properties.gc64
+    end,
+    bytecode = function() end,
+  })
+  chunk()
+
+  local engine_version = jit ~= nil and jit.version:match("^LuaJIT %d+%.%d+") or _VERSION
+  local has_ffi, ffi = pcall(require, "ffi")
+  local engine_gc64 = has_ffi and ffi.abi("gc64")
+  if version ~= engine_version or gc64 ~= engine_gc64 then
+    local function describe(luajit_version, luajit_gc64)
+      return tostring(luajit_version) .. (luajit_gc64 and " (GC64)" or "")
+    end
+    return "The scripts of this data.solarus were compiled with " .. describe(version, gc64)
+        .. " but the engine uses " .. describe(engine_version, engine_gc64)
+        .. ": rebuild data.solarus without ZSDX_BYTECODE"
+  end
+  return nil
+end
+
+local bytecode_error = get_bytecode_error()
+if bytecode_error ~= nil then
+  print("Error: " .. bytecode_error)
+  sol.main.exit()
+  return
+end
+
+-- If there is a file called "debug" in the write directory, enable debug mode.
+local debug_enabled = sol.file.exists("debug")
 function sol.main.is_debug_enabled()
   return debug_enabled
 end
 
+-- In debug mode, track the memory of the objects created from now on.
+if debug_enabled then
+  require("memory_tracker")
+end
+
+-- If there is a file called "benchmark" in the write directory,
+-- or if ZSDX_BENCHMARK is set, measure the maps (see benchmark.lua).
+local benchmark_enabled = sol.file.exists("benchmark") or os.getenv("ZSDX_BENCHMARK") ~= nil
+
+local quest_manager = require("quest_manager")
+local savegame_summary = require("savegame_summary")
+local startup = require("startup")
+
+-- The console and the profiler are only loaded the first time they are opened.
+local console = nil
+local profiler = nil
+local function is_console_enabled()
+  return console ~= nil and console.enabled
+end
+
 -- Event called when the program starts.
 function sol.main:on_started()
 
+  startup.start()
+
   -- Make quest-specific initializations.
   quest_manager:initialize_quest()
 
   -- Load built-in settings (audio volume, video mode, etc.).
   sol.main.load_settings()
+  startup.mark("settings")
+
+  -- In benchmark mode, measure the maps instead of showing the menus.
+  if benchmark_enabled then
+    require("sound_manager").start_preloading()
+    require("music_manager").initialize()
+    require("benchmark").start()
+    return
+  end
 
-  -- If there is a file called "debug" in the write directory, enable debug mode.
-  debug_enabled = sol.file.exists("debug")
+  -- Load the sound effects in the background while the menus run,
+  -- and fade the music between maps.
+  startup.prefetch(function() require("sound_manager").start_preloading() end)
+  startup.prefetch(function() require("music_manager").initialize() end)
 
-  local solarus_logo = require("menus/solarus_logo")
-  local team_logo = require("menus/team_logo")
-  local language_menu = require("menus/language")
-  local title_screen = require("menus/title")
-  local savegame_menu = require("menus/savegames")
+  -- Each menu is loaded while the previous one runs.
+  local function start_savegame_menu()
+    startup.prefetch(function() require("menus/savegames") end)
+    startup.prefetch(function() require("menus/savegames").preload() end)
+  end
 
-  -- Show the Solarus logo first.
-  sol.menu.start(self, solarus_logo)
+  local function start_title_screen()
+    local title_screen = require("menus/title")
+    title_screen.on_ready = function()
+      startup.mark("title_ready")
+      start_savegame_menu()
+    end
 
-  -- Then the Solarus team logo, unless a game was started by a debug key.
-  solarus_logo.on_finished = function()
-    if self.game == nil then
-      sol.menu.start(self, team_logo)
+    -- Then the savegame menu.
+    title_screen.on_finished = function()
+      if self.game == nil then
+        sol.menu.start(self, require("menus/savegames"))
+        startup.mark("file_select_ready")
+      end
     end
+    sol.menu.start(self, title_screen)
   end
 
-  -- Then the language selection menu.
-  team_logo.on_finished = function()
-    if self.game == nil then
-      sol.menu.start(self, language_menu)
+  local function start_language_menu()
+    local language_menu = require("menus/language")
+
+    -- Then the title screen.
+    language_menu.on_finished = function()
+      if self.game == nil then
+        start_title_screen()
+      end
     end
+    sol.menu.start(self, language_menu)
   end
 
-  -- Then the title screen.
-  language_menu.on_finished = function()
-    if self.game == nil then
-      sol.menu.start(self, title_screen)
+  local function start_team_logo()
+    local team_logo = require("menus/team_logo")
+    startup.prefetch(function() require("menus/language") end)
+    startup.prefetch(function() require("menus/title") end)
+    startup.prefetch(function() require("menus/title").preload() end)
+
+    -- Then the language selection menu.
+    team_logo.on_finished = function()
+      startup.mark("logo")
+      if self.game == nil then
+        start_language_menu()
+      end
     end
+    sol.menu.start(self, team_logo)
   end
 
-  -- Then the savegame menu.
-  title_screen.on_finished = function()
+  -- Show the Solarus logo first.
+  local solarus_logo = require("menus/solarus_logo")
+  sol.menu.start(self, solarus_logo)
+  startup.prefetch(function() require("menus/team_logo") end)
+
+  -- Then the Solarus team logo, unless a game was started by a debug key.
+  solarus_logo.on_finished = function()
     if self.game == nil then
-      sol.menu.start(self, savegame_menu)
+      start_team_logo()
     end
   end
 end
@@ -61,6 +160,7 @@ end
 -- Event called when the program stops.
 function sol.main:on_finished()
 
+  require("music_manager").stop_fading()
   sol.main.save_settings()
 end
 
@@ -69,25 +169,29 @@ function sol.main:debug_on_key_pressed(key, modifiers)
   local handled = true
   if key == "f1" then
     if sol.game.exists("save1.dat") then
-      self.game = sol.game.load("save1.dat")
+      self.game = savegame_summary.load("save1.dat")
       sol.menu.stop_all(self)
       self:start_savegame(self.game)
     end
   elseif key == "f2" then
     if sol.game.exists("save2.dat") then
-      self.game = sol.game.load("save2.dat")
+      self.game = savegame_summary.load("save2.dat")
       sol.menu.stop_all(self)
       self:start_savegame(self.game)
     end
   elseif key == "f3" then
     if sol.game.exists("save3.dat") then
-      self.game = sol.game.load("save3.dat")
+      self.game = savegame_summary.load("save3.dat")
       sol.menu.stop_all(self)
       self:start_savegame(self.game)
     end
-  elseif key == "f12" and not console.enabled then
+  elseif key == "f12" and not is_console_enabled() then
+    console = console or require("console")
     sol.menu.start(self, console)
-  elseif sol.main.game ~= nil and not console.enabled then
+  elseif key == "f10" and not is_console_enabled() then
+    profiler = profiler or require("profiler")
+    profiler:toggle()
+  elseif sol.main.game ~= nil and not is_console_enabled() then
     local game = sol.main.game
     local hero = nil
     if game ~= nil and game:get_map() ~= nil then
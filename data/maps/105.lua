@@ -101,7 +101,7 @@ end
 -- hidden enemies
 local function hidden_enemy_dead(enemy)
 
-  if not map:has_entities("hidden_enemy")
+  if not map:has_group_entities("hidden_enemy")
       and not hidden_chest:is_enabled() then
     map:move_camera(1128, 2040, 250, function()
       sol.audio.play_sound("chest_appears")
@@ -109,14 +109,14 @@ local function hidden_enemy_dead(enemy)
     end)
   end
 end
-for enemy in map:get_entities("hidden_enemy") do
+for enemy in map:get_group_entities("hidden_enemy") do
   enemy.on_dead = hidden_enemy_dead
 end
 
 -- south door
 local function s_door_enemy_dead(enemy)
 
-  if not map:has_entities("s_door_enemy")
+  if not map:has_group_entities("s_door_enemy")
       and not s_door:is_open() then
     map:move_camera(1768, 1800, 250, function()
       sol.audio.play_sound("secret")
@@ -124,14 +124,14 @@ local function s_door_enemy_dead(enemy)
     end)
   end
 end
-for enemy in map:get_entities("s_door_enemy") do
+for enemy in map:get_group_entities("s_door_enemy") do
   enemy.on_dead = s_door_enemy_dead
 end
 
 -- west enemies room
 local function w_room_enemy_dead(enemy)
 
-  if not map:has_entities("w_room_enemy") then
+  if not map:has_group_entities("w_room_enemy") then
     sol.audio.play_sound("chest_appears")
     w_room_chest:set_enabled(true)
     if not w_room_door:is_open() then
@@ -143,7 +143,7 @@ end
 -- east enemies room
 local function e_room_enemy_dead(enemy)
 
-  if not map:has_entities("e_room_enemy")
+  if not map:has_group_entities("e_room_enemy")
       and not e_room_chest:is_enabled() then
     map:move_camera(2136, 1120, 250, function()
       sol.audio.play_sound("chest_appears")
@@ -151,7 +151,7 @@ local function e_room_enemy_dead(enemy)
     end)
   end
 end
-for enemy in map:get_entities("e_room_enemy") do
+for enemy in map:get_group_entities("e_room_enemy") do
   enemy.on_dead = e_room_enemy_dead
 end
 
@@ -236,7 +236,7 @@ local function puzzle_b_switch_left(switch)
 
   switch:set_locked(false)
 end
-for switch in map:get_entities("puzzle_b_switch") do
+for switch in map:get_group_entities("puzzle_b_switch") do
   switch.on_activated = puzzle_b_switch_activated
   switch.on_left = puzzle_b_switch_left
 end
@@ -277,7 +277,7 @@ local function puzzle_a_switch_activated(switch)
     end
   end
 end
-for switch in map:get_entities("puzzle_a_switch") do
+for switch in map:get_group_entities("puzzle_a_switch") do
   switch.on_activated = puzzle_a_switch_activated
 end
 
@@ -314,7 +314,7 @@ function close_w_room_sensor:on_activated()
       direction = 0,
       treasure_name = "random"
     }
-    for enemy in map:get_entities("w_room_enemy") do
+    for enemy in map:get_group_entities("w_room_enemy") do
       enemy.on_dead = w_room_enemy_dead
     end
   end
@@ -353,14 +353,14 @@ end
 close_puzzle_b_door_sensor_2.on_activated = close_puzzle_b_door_sensor.on_activated
 
 -- save solid ground location
-for sensor in map:get_entities("save_solid_ground_sensor") do
+for sensor in map:get_group_entities("save_solid_ground_sensor") do
   function sensor:on_activated()
     hero:save_solid_ground()
   end
 end
 
 -- reset solid ground location
-for sensor in map:get_entities("reset_solid_ground_sensor") do
+for sensor in map:get_group_entities("reset_solid_ground_sensor") do
   function sensor:on_activated()
     hero:reset_solid_ground()
   end
@@ -393,7 +393,7 @@ local function torch_collision_fire(torch)
     end)
   end
 end
-for torch in map:get_entities("torch_") do
+for torch in map:get_group_entities("torch_") do
   torch.on_interaction = torch_interaction
   torch.on_collision_fire = torch_collision_fire
 end
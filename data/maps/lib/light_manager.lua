@@ -2,7 +2,18 @@
 -- into the dark.
 --
 -- Your map will have the following new functions:
--- map:get_light(), map:set_light() and the event map:on_draw().
+-- map:get_light(), map:set_light(), map:add_light_source(),
+-- map:remove_light_source() and the event map:on_draw().
+--
+-- The map is dark when its light is 0 and no light source is active.
+-- Light sources are any objects, like torches lit by the lamp: each one
+-- lights the whole room until it is removed.
+--
+-- Each dark overlay entities/dark<direction>.png is 640x480 but opaque
+-- black except around the hero. Only this part is kept, as a small mask
+-- cropped from the overlay the first time the hero faces this direction
+-- in a dark map. Each frame draws the mask around the hero and fills the
+-- rest of the screen with black.
 --
 -- Usage:
 --
@@ -15,22 +26,48 @@
 -- -- Later:
 -- your_map:set_light(0)  -- Put the map into the dark.
 -- your_map:set_light(1)  -- Restore normal light.
+-- your_map:add_light_source(torch)  -- Lit while the torch is lit.
+-- your_map:remove_light_source(torch)
 
 local light_manager = {}
 
--- Dark overlay for each hero direction.
-local dark_surfaces = {
-  [0] = sol.surface.create("entities/dark0.png"),
-  [1] = sol.surface.create("entities/dark1.png"),
-  [2] = sol.surface.create("entities/dark2.png"),
-  [3] = sol.surface.create("entities/dark3.png")
-}
 local black = {0, 0, 0}
 
+-- Part of each overlay that is not opaque black: x, y, width, height.
+-- The hero is at 320,240 in the overlays.
+local mask_regions = {
+  [0] = { 296, 196, 96, 88 },
+  [1] = { 276, 164, 88, 96 },
+  [2] = { 248, 196, 96, 88 },
+  [3] = { 276, 212, 88, 96 },
+}
+
+-- Mask of each hero direction, cropped when first needed.
+local masks = {}
+local function get_mask(direction)
+
+  local mask = masks[direction]
+  if mask == nil then
+    local region = mask_regions[direction]
+    local overlay = sol.surface.create("entities/dark" .. direction .. ".png")
+    overlay:set_blend_mode("none")  -- Copy the transparency as is.
+    mask = sol.surface.create(region[3], region[4])
+    overlay:draw_region(region[1], region[2], region[3], region[4], mask, 0, 0)
+    masks[direction] = mask
+  end
+  return mask
+end
+
 function light_manager.enable_light_features(map)
 
+  local light_sources = {}
+  local num_light_sources = 0
+
   map.light = 1
   map.get_light = function(map)
+    if num_light_sources > 0 then
+      return 1
+    end
     return map.light
   end
 
@@ -38,43 +75,54 @@ function light_manager.enable_light_features(map)
     map.light = light
   end
 
+  map.add_light_source = function(map, source)
+    if not light_sources[source] then
+      light_sources[source] = true
+      num_light_sources = num_light_sources + 1
+    end
+  end
+
+  map.remove_light_source = function(map, source)
+    if light_sources[source] then
+      light_sources[source] = nil
+      num_light_sources = num_light_sources - 1
+    end
+  end
+
   map.on_draw = function(map, dst_surface)
 
-    if map.light ~= 0 then
+    if map:get_light() ~= 0 then
       -- Normal light: nothing special to do.
       return
     end
 
-    -- Dark room.
+    -- Dark room: the mask around the hero, black everywhere else.
     local screen_width, screen_height = dst_surface:get_size()
     local hero = map:get_entity("hero")
     local hero_x, hero_y = hero:get_center_position()
     local camera_x, camera_y = map:get_camera():get_bounding_box()
-    local x = 320 - hero_x + camera_x
-    local y = 240 - hero_y + camera_y
-    local dark_surface = dark_surfaces[hero:get_direction()]
-    dark_surface:draw_region(
-        x, y, screen_width, screen_height, dst_surface)
-
-    -- dark_surface may be too small if the screen size is greater
-    -- than 320x240. In this case, add black bars.
-    if x < 0 then
-      dst_surface:fill_color(black, 0, 0, -x, screen_height)
-    end
+    local direction = hero:get_direction()
+    local region = mask_regions[direction]
+    local mask_x = hero_x - camera_x - 320 + region[1]
+    local mask_y = hero_y - camera_y - 240 + region[2]
+    local mask_width, mask_height = region[3], region[4]
+    get_mask(direction):draw(dst_surface, mask_x, mask_y)
 
-    if y < 0 then
-      dst_surface:fill_color(black, 0, 0, screen_width, -y)
+    local top = math.min(math.max(mask_y, 0), screen_height)
+    local bottom = math.min(math.max(mask_y + mask_height, 0), screen_height)
+    local left = math.min(math.max(mask_x, 0), screen_width)
+    local right = math.min(math.max(mask_x + mask_width, 0), screen_width)
+    if top > 0 then
+      dst_surface:fill_color(black, 0, 0, screen_width, top)
     end
-
-    local dark_surface_width, dark_surface_height = dark_surface:get_size()
-    if x > dark_surface_width - screen_width then
-      dst_surface:fill_color(black, dark_surface_width - x, 0,
-          x - dark_surface_width + screen_width, screen_height)
+    if bottom < screen_height then
+      dst_surface:fill_color(black, 0, bottom, screen_width, screen_height - bottom)
     end
-
-    if y > dark_surface_height - screen_height then
-      dst_surface:fill_color(black, 0, dark_surface_height - y,
-          screen_width, y - dark_surface_height + screen_height)
+    if left > 0 and bottom > top then
+      dst_surface:fill_color(black, 0, top, left, bottom - top)
+    end
+    if right < screen_width and bottom > top then
+      dst_surface:fill_color(black, right, top, screen_width - right, bottom - top)
     end
   end
 end
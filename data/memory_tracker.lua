@@ -0,0 +1,373 @@
+-- Estimates the memory kept by the quest, by kind of asset and by owner.
+--
+-- Surfaces, sprites and text surfaces created by Lua are tracked from
+-- their creation, with the script that created them as owner (the menu,
+-- the HUD element, the map or the enemy script). Images got from
+-- surface_cache.lua belong to the script that requested them.
+-- Objects stop being counted when they are garbage-collected.
+-- The sprites of the entities of the current map are counted too, including
+-- the ones created by the engine, with the map as owner.
+--
+-- Sizes are estimated when a report is made:
+-- - surfaces and text surfaces: 4 bytes per pixel,
+-- - sprites: the images of their sprite sheet, counted once per sprite,
+-- - fonts used by text surfaces: the file for outline fonts, the image for
+--   bitmap fonts (the engine keeps fonts loaded once used),
+-- - sounds loaded by sound_manager.lua: the decoded samples.
+--
+-- In the console:
+-- memory:report()                -- Writes memory_report.txt in the write
+--                                -- directory and shows the total.
+-- memory.budget_bytes = 32 * 1024 * 1024
+--
+-- When the map changes, a warning is printed if the total exceeds the budget.
+--
+-- All of this only works in debug mode: otherwise the creation functions
+-- are not wrapped and nothing is checked when the map changes.
+--
+-- With ZSDX_BYTECODE, scripts are stripped of their debug information and
+-- the script creating an object may be unknown: these objects are counted
+-- with the owner "unknown", which leaves a report by category only.
+--
+-- Usage:
+-- local memory_tracker = require("memory_tracker")
+-- (as early as possible, before other scripts create objects)
+
+local sound_manager = require("sound_manager")
+local surface_cache = require("surface_cache")
+
+local memory_tracker = {
+  enabled = sol.main.is_debug_enabled(),
+  budget_bytes = 64 * 1024 * 1024,
+  report_file_name = "memory_report.txt",
+}
+
+-- Category and owner of each live object.
+local categories = setmetatable({}, { __mode = "k" })
+local owners = setmetatable({}, { __mode = "k" })
+
+local fonts_used = {}          -- Fonts ever used by text surfaces.
+local sprite_sheet_bytes = {}  -- Estimated size of the images of each sprite.
+local image_bytes = {}         -- Size of each image file.
+local sound_bytes = {}         -- Size of the samples of each sound.
+
+-- Scripts that create objects on behalf of other ones.
+local forwarding_sources = {
+  memory_tracker = true,
+  surface_cache = true,
+}
+
+-- Returns the script that is creating an object.
+local function get_owner()
+
+  local level = 2
+  while true do
+    local info = debug.getinfo(level, "S")
+    if info == nil then
+      return "engine"
+    end
+    if info.what ~= "C" then
+      if info.source:sub(1, 1) == "=" then
+        -- No file name, like "=?" for stripped bytecode.
+        return "unknown"
+      end
+      local source = info.source:gsub("^@", ""):gsub("%.lua$", "")
+      if not forwarding_sources[source] then
+        return source
+      end
+    end
+    level = level + 1
+  end
+end
+
+-- Replaces a creation function by one that tracks the objects created.
+local function track(api, category)
+
+  local create = api.create
+  api.create = function(...)
+    local object = create(...)
+    if object ~= nil then
+      categories[object] = category
+      owners[object] = get_owner()
+    end
+    return object
+  end
+end
+
+if memory_tracker.enabled then
+  track(sol.surface, "surface")
+  track(sol.sprite, "sprite")
+  track(sol.text_surface, "text_surface")
+end
+
+-- Returns the width and height of a PNG image, or nil if it cannot be read.
+local function get_png_size(file_name)
+
+  local file = sol.file.open(file_name, "rb")
+  if file == nil then
+    return nil
+  end
+  local header = file:read(24)
+  file:close()
+  if header == nil or #header < 24 or header:sub(13, 16) ~= "IHDR" then
+    return nil
+  end
+  local function read_uint32(index)
+    local b1, b2, b3, b4 = header:byte(index, index + 3)
+    return ((b1 * 256 + b2) * 256 + b3) * 256 + b4
+  end
+  return read_uint32(17), read_uint32(21)
+end
+
+-- Returns the decoded size of an image file.
+local function get_image_bytes(file_name)
+
+  local bytes = image_bytes[file_name]
+  if bytes == nil then
+    local width, height = get_png_size(file_name)
+    bytes = width and width * height * 4 or 0
+    image_bytes[file_name] = bytes
+  end
+  return bytes
+end
+
+-- Returns the size of the images of a sprite sheet,
+-- read from its data file the first time.
+local function get_sprite_sheet_bytes(animation_set_id)
+
+  local bytes = sprite_sheet_bytes[animation_set_id]
+  if bytes == nil then
+    bytes = 0
+    local chunk = sol.main.load_file("sprites/" .. animation_set_id .. ".dat")
+    if chunk ~= nil then
+      local src_images = {}
+      setfenv(chunk, {
+        animation = function(properties)
+          local src_image = properties.src_image
+          if src_image ~= nil and src_image ~= "tileset" then
+            src_images[src_image] = true
+          end
+        end,
+      })
+      if pcall(chunk) then
+        for src_image in pairs(src_images) do
+          bytes = bytes + get_image_bytes("sprites/" .. src_image)
+        end
+      end
+    end
+    sprite_sheet_bytes[animation_set_id] = bytes
+  end
+  return bytes
+end
+
+-- Returns the size of a file.
+local function get_file_bytes(file_name)
+
+  local file = sol.file.open(file_name, "rb")
+  if file == nil then
+    return 0
+  end
+  local size = file:seek("end") or 0
+  file:close()
+  return size
+end
+
+-- Returns the size in memory of a font.
+local function get_font_bytes(font_id)
+
+  local font_file = "fonts/" .. font_id
+  if sol.file.exists(font_file .. ".png") then
+    return get_image_bytes(font_file .. ".png")
+  end
+  for _, extension in ipairs({ ".ttf", ".ttc", ".otf", ".fon" }) do
+    if sol.file.exists(font_file .. extension) then
+      return get_file_bytes(font_file .. extension)
+    end
+  end
+  return 0
+end
+
+-- Returns the size of the decoded samples of an OGG sound:
+-- the number of samples from the last page, 16 bits per channel.
+local function get_sound_bytes(sound_id)
+
+  local bytes = sound_bytes[sound_id]
+  if bytes ~= nil then
+    return bytes
+  end
+
+  bytes = 0
+  local file = sol.file.open("sounds/" .. sound_id .. ".ogg", "rb")
+  if file ~= nil then
+    local header = file:read(128) or ""
+    local size = file:seek("end") or 0
+    file:seek("set", math.max(0, size - 8192))
+    local tail = file:read("*a") or ""
+    file:close()
+
+    local vorbis_index = header:find("\1vorbis", 1, true)
+    local last_page_index = nil
+    local index = tail:find("OggS", 1, true)
+    while index ~= nil do
+      last_page_index = index
+      index = tail:find("OggS", index + 1, true)
+    end
+    if vorbis_index ~= nil and last_page_index ~= nil then
+      local num_channels = header:byte(vorbis_index + 11)
+      local num_samples = 0
+      for i = 5, 0, -1 do
+        num_samples = num_samples * 256 + (tail:byte(last_page_index + 6 + i) or 0)
+      end
+      bytes = num_samples * num_channels * 2
+    end
+  end
+  sound_bytes[sound_id] = bytes
+  return bytes
+end
+
+-- Returns the size of an object, and of its sprite sheet
+-- if it was not counted yet.
+local function get_object_bytes(object, category, sheets_counted)
+
+  if category == "sprite" or category == "entity_sprite" then
+    local animation_set_id = object:get_animation_set()
+    if sheets_counted[animation_set_id] then
+      return 0
+    end
+    sheets_counted[animation_set_id] = true
+    return get_sprite_sheet_bytes(animation_set_id)
+  end
+
+  if category == "text_surface" then
+    local font_id = object:get_font()
+    if font_id ~= nil then
+      fonts_used[font_id] = true
+    end
+  end
+  local width, height = object:get_size()
+  return (width or 0) * (height or 0) * 4
+end
+
+-- Returns the rows of the report: the count and estimated size
+-- of each category and owner, the biggest first, and the total size.
+function memory_tracker:get_usage()
+
+  local rows = {}
+  local rows_by_key = {}
+  local total_bytes = 0
+  local sheets_counted = {}
+
+  local function add(category, owner, count, bytes)
+    local key = category .. " " .. owner
+    local row = rows_by_key[key]
+    if row == nil then
+      row = { category = category, owner = owner, count = 0, bytes = 0 }
+      rows_by_key[key] = row
+      rows[#rows + 1] = row
+    end
+    row.count = row.count + count
+    row.bytes = row.bytes + bytes
+    total_bytes = total_bytes + bytes
+  end
+
+  for object, category in pairs(categories) do
+    add(category, owners[object], 1, get_object_bytes(object, category, sheets_counted))
+  end
+
+  -- Sprites of the entities of the current map.
+  local game = sol.main.game
+  local map = game ~= nil and game:get_map() or nil
+  if map ~= nil then
+    local owner = "maps/" .. map:get_id()
+    for entity in map:get_entities() do
+      for _, sprite in entity:get_sprites() do
+        if categories[sprite] == nil then
+          add("entity_sprite", owner, 1, get_object_bytes(sprite, "entity_sprite", sheets_counted))
+        end
+      end
+    end
+  end
+
+  for font_id in pairs(fonts_used) do
+    add("font", font_id, 1, get_font_bytes(font_id))
+  end
+
+  for _, sound_id in ipairs(sound_manager.get_loaded_sounds()) do
+    add("sound", "sound_manager", 1, get_sound_bytes(sound_id))
+  end
+
+  table.sort(rows, function(row_1, row_2)
+    if row_1.bytes ~= row_2.bytes then
+      return row_1.bytes > row_2.bytes
+    end
+    return row_1.category .. row_1.owner < row_2.category .. row_2.owner
+  end)
+  return rows, total_bytes
+end
+
+-- Returns the estimated size of everything tracked.
+function memory_tracker:get_total_bytes()
+
+  local _, total_bytes = self:get_usage()
+  return total_bytes
+end
+
+local function format_kb(bytes)
+  return string.format("%.1f KB", bytes / 1024)
+end
+
+-- Writes the usage to the report file and returns a summary line.
+function memory_tracker:report()
+
+  if not self.enabled then
+    return "Memory: only tracked in debug mode"
+  end
+
+  collectgarbage()
+  local rows, total_bytes = self:get_usage()
+
+  local file = sol.file.open(self.report_file_name, "w")
+  file:write(string.format("Total: %s, budget: %s, Lua: %.1f KB,"
+      .. " images cached by surface_cache: %s\n\n",
+      format_kb(total_bytes), format_kb(self.budget_bytes),
+      collectgarbage("count"), format_kb(surface_cache.get_total_bytes())))
+  file:write(string.format("%-14s %-40s %6s %12s\n", "category", "owner", "count", "size"))
+  for _, row in ipairs(rows) do
+    file:write(string.format("%-14s %-40s %6d %12s\n",
+        row.category, row.owner, row.count, format_kb(row.bytes)))
+  end
+  file:close()
+
+  return "Memory: " .. format_kb(total_bytes) .. " (see "
+      .. sol.main.get_quest_write_dir() .. "/" .. self.report_file_name .. ")"
+end
+
+-- Called when the map changes: warns if the budget is exceeded.
+function memory_tracker:on_map_changed(map)
+
+  if not self.enabled then
+    return
+  end
+
+  local rows, total_bytes = self:get_usage()
+  if total_bytes <= self.budget_bytes then
+    return
+  end
+
+  -- Forget the objects no longer used before warning.
+  collectgarbage()
+  rows, total_bytes = self:get_usage()
+  if total_bytes <= self.budget_bytes then
+    return
+  end
+
+  print(string.format("Warning: estimated memory of %s exceeds the budget of %s on map %s",
+      format_kb(total_bytes), format_kb(self.budget_bytes), map:get_id()))
+  for i = 1, math.min(5, #rows) do
+    local row = rows[i]
+    print(string.format("  %s %s: %d, %s",
+        row.category, row.owner, row.count, format_kb(row.bytes)))
+  end
+end
+
+return memory_tracker
@@ -1,3 +1,30 @@
+local surface_cache = require("surface_cache")
+
+-- Returns the number of bytes of the utf-8 character that starts
+-- with the specified byte.
+local function get_utf8_length(byte)
+
+  if byte >= 240 then
+    return 4  -- 11110xxx
+  elseif byte >= 224 then
+    return 3  -- 1110xxxx
+  elseif byte >= 192 then
+    return 2  -- 110xxxxx
+  end
+  return 1
+end
+
+-- Returns the text of a dialog line as it is displayed:
+-- $0, $1, $2 and $3 are not shown (see dialog_box:add_character()).
+local function get_displayed_text(line)
+
+  return (line:gsub("%$(.?)", function(character)
+    if character:match("^[0-3]$") then
+      return ""
+    end
+  end))
+end
+
 return function(game)
 
   local dialog_box = {
@@ -17,7 +44,9 @@ return function(game)
     next_line = nil,             -- Next line to display or nil.
     line_it = nil,               -- Iterator over of all lines of the dialog.
     lines = {},                  -- Array of the text of the 3 visible lines.
-    line_surfaces = {},          -- Array of the 3 text surfaces.
+    line_surfaces = {},          -- Array of the 3 text surfaces, each showing a whole line.
+    shown_lengths = {},          -- Array of the number of bytes of each line already shown.
+    shown_widths = {},           -- Array of the width in pixels of each line already shown.
     line_index = nil,            -- Line currently being shown.
     char_index = nil,            -- Next character to show in the current line.
     char_delay = nil,            -- Delay between two characters in milliseconds.
@@ -26,6 +55,9 @@ return function(game)
     gradual = true,              -- Whether text is displayed gradually.
 
     -- Graphics.
+    font = nil,
+    font_size = nil,
+    measure_surface = nil,       -- To measure texts if the engine cannot predict sizes.
     dialog_surface = nil,
     box_img = nil,
     icons_img = nil,
@@ -53,6 +85,7 @@ return function(game)
 
     -- Initialize dialog box data.
     local font, font_size = sol.language.get_dialog_font()
+    dialog_box.font, dialog_box.font_size = font, font_size
     for i = 1, nb_visible_lines do
       dialog_box.lines[i] = ""
       dialog_box.line_surfaces[i] = sol.text_surface.create{
@@ -61,10 +94,12 @@ return function(game)
         font = font,
         font_size = font_size,
       }
+      dialog_box.shown_lengths[i] = 0
+      dialog_box.shown_widths[i] = 0
     end
     dialog_box.dialog_surface = sol.surface.create(sol.video.get_quest_size())
-    dialog_box.box_img = sol.surface.create("hud/dialog_box.png")
-    dialog_box.icons_img = sol.surface.create("hud/dialog_icons.png")
+    dialog_box.box_img = surface_cache.get(dialog_box, "hud/dialog_box.png")
+    dialog_box.icons_img = surface_cache.get(dialog_box, "hud/dialog_icons.png")
     dialog_box.end_lines_sprite = sol.sprite.create("hud/dialog_box_message_end")
     game:set_dialog_style("box")
   end
@@ -76,6 +111,7 @@ return function(game)
       if game:is_dialog_enabled() then
         sol.menu.stop(dialog_box)
       end
+      surface_cache.release(dialog_box)
       game.dialog_box = nil
     end
   end
@@ -86,6 +122,7 @@ return function(game)
     dialog_box.dialog = dialog
     dialog_box.info = info
     sol.menu.start(game, dialog_box)
+    game:hud_notify("dialog")
   end
 
   -- Called by the engine when a dialog finishes.
@@ -94,6 +131,7 @@ return function(game)
     sol.menu.stop(dialog_box)
     dialog_box.dialog = nil
     dialog_box.info = nil
+    game:hud_notify("dialog")
   end
 
   -- Sets the style of the dialog box for subsequent dialogs.
@@ -313,15 +351,18 @@ return function(game)
       game:set_custom_command_effect("attack", nil)
     end
 
-    -- Prepare the 3 lines.
+    -- Prepare the 3 lines: each one is rendered once and then shown
+    -- from the left, one character at a time.
     for i = 1, nb_visible_lines do
-      self.line_surfaces[i]:set_text("")
       if self:has_more_lines() then
         self.lines[i] = self.next_line
         self.next_line = self.line_it()
       else
         self.lines[i] = ""
       end
+      self.line_surfaces[i]:set_text(get_displayed_text(self.lines[i]))
+      self.shown_lengths[i] = 0
+      self.shown_widths[i] = 0
     end
     self.line_index = 1
     self.char_index = 1
@@ -331,6 +372,41 @@ return function(game)
     end
   end
 
+  -- Returns the width in pixels of a text in the dialog font.
+  function dialog_box:get_text_width(text)
+
+    if text == "" then
+      return 0
+    end
+    if sol.text_surface.get_predicted_size ~= nil then
+      return (sol.text_surface.get_predicted_size(self.font, self.font_size, text))
+    end
+    if self.measure_surface == nil then
+      self.measure_surface = sol.text_surface.create{
+        font = self.font,
+        font_size = self.font_size,
+      }
+    end
+    self.measure_surface:set_text(text)
+    return (self.measure_surface:get_size())
+  end
+
+  -- Shows the next character of a visible line.
+  -- The line is already rendered: measuring the text shown so far keeps
+  -- the characters where the font places them in the whole line.
+  function dialog_box:append_character(line_index, character)
+
+    local text_surface = self.line_surfaces[line_index]
+    local text = text_surface:get_text()
+    local length = self.shown_lengths[line_index] + #character
+    self.shown_lengths[line_index] = length
+    if length >= #text then
+      self.shown_widths[line_index] = text_surface:get_size()
+    else
+      self.shown_widths[line_index] = self:get_text_width(text:sub(1, length))
+    end
+  end
+
   -- Adds the next character to the dialog box.
   -- If this is a special character (like $0, $v, etc.),
   -- the corresponding action is performed.
@@ -343,14 +419,13 @@ return function(game)
     end
     self.char_index = self.char_index + 1
     local additional_delay = 0
-    local text_surface = self.line_surfaces[self.line_index]
 
     -- Special characters:
     -- - $1, $2 and $3: slow, medium and fast
     -- - $0: pause
     -- - $v: variable
     -- - space: don't add the delay
-    -- - 110xxxx: multibyte character
+    -- - 110xxxxx, 1110xxxx, 11110xxx: multibyte character
 
     local special = false
     if current_char == "$" then
@@ -378,24 +453,20 @@ return function(game)
 
       else
         -- Not a special char, actually.
-        text_surface:set_text(text_surface:get_text() .. "$")
+        self:append_character(self.line_index, "$")
         special = false
       end
     end
 
     if not special then
       -- Normal character to be displayed.
-      text_surface:set_text(text_surface:get_text() .. current_char)
-
-      -- If this is a multibyte character, also add the next byte.
-      local byte = current_char:byte()
-      if byte >= 192 and byte < 224 then
-        -- The first byte is 110xxxxx: the character is stored with
-        -- two bytes (utf-8).
-        current_char = line:sub(self.char_index, self.char_index)
-        self.char_index = self.char_index + 1
-        text_surface:set_text(text_surface:get_text() .. current_char)
+      -- If this is a multibyte character (utf-8), also take the next bytes.
+      local length = get_utf8_length(current_char:byte())
+      if length > 1 then
+        current_char = line:sub(self.char_index - 1, self.char_index + length - 2)
+        self.char_index = self.char_index + length - 1
       end
+      self:append_character(self.line_index, current_char)
 
       if current_char == " " then
         -- Remove the delay for whitespace characters.
@@ -507,7 +578,12 @@ return function(game)
         -- The last two lines are the answer to a question.
         text_x = text_x + 24
       end
-      self.line_surfaces[i]:draw(self.dialog_surface, text_x, text_y)
+      local width = self.shown_widths[i]
+      if width > 0 then
+        local line_surface = self.line_surfaces[i]
+        local _, height = line_surface:get_size()
+        line_surface:draw_region(0, 0, width, height, self.dialog_surface, text_x, text_y)
+      end
     end
 
     -- Draw the icon.
@@ -1,3 +1,6 @@
+local music_manager = require("music_manager")
+local surface_cache = require("surface_cache")
+
 return function(game)
 
   local game_over_menu = {}  -- The game-over menu.
@@ -36,7 +39,7 @@ return function(game)
     hero_was_visible = hero:is_visible()
     hero:set_visible(false)
     music = sol.audio.get_music()
-    background_img = sol.surface.create("gameover_menu.png", true)
+    background_img = surface_cache.get(self, "gameover_menu.png", true)
     local tunic = game:get_ability("tunic")
     hero_dead_sprite = sol.sprite.create("hero/tunic" .. tunic)
     hero_dead_sprite:set_animation("hurt")
@@ -86,7 +89,7 @@ return function(game)
               game:add_life(7 * 4)  -- Restore 7 hearts.
               sol.timer.start(self, 1000, function()
                 state = "resume_game"
-                sol.audio.play_music(music)
+                music_manager.play(music)
                 game:stop_game_over()
                 sol.menu.stop(self)
               end)
@@ -117,6 +120,7 @@ return function(game)
     fairy_sprite = nil
     cursor_position = nil
     state = nil
+    surface_cache.release(self)
     sol.timer.stop_all(self)
   end
 
@@ -35,40 +35,110 @@ local item_names = {
   "bottle_4"
 }
 
+-- The sprites and counters of each game are kept from a pause to the next
+-- one, and drawn once on a surface: only the slots whose item changed are
+-- created again, and only animated items are drawn at each frame.
+local grids = setmetatable({}, { __mode = "k" })
+local grid_margin = 16  -- Sprites are drawn around their origin.
+local grid_width, grid_height = 7 * 32 + 2 * grid_margin, 4 * 32 + 2 * grid_margin
+
+-- Returns the grid of items of a game, creating it the first time.
+local function get_grid(game)
+
+  local grid = grids[game]
+  if grid == nil then
+    grid = {
+      surface = sol.surface.create(grid_width, grid_height),
+      cursor_sprite = sol.sprite.create("menus/pause_cursor"),
+      slots = {},  -- Variant, amount, sprite and counter of each item.
+      animated = {},  -- Indexes of the slots drawn at each frame.
+    }
+    for k = 1, #item_names do
+      grid.slots[k] = { variant = 0 }
+    end
+    grids[game] = grid
+  end
+  return grid
+end
+
+-- Creates again the sprite and counter of a slot if its item changed.
+-- Returns whether the slot changed.
+local function update_slot(slot, item)
+
+  local variant = item:get_variant()
+  local amount, maximum = nil, nil
+  if variant > 0 and item:has_amount() then
+    amount = item:get_amount()
+    maximum = item:get_max_amount()
+  end
+  if variant == slot.variant
+      and amount == slot.amount
+      and maximum == slot.maximum then
+    return false
+  end
+
+  if variant ~= slot.variant then
+    slot.sprite = nil
+    if variant > 0 then
+      slot.sprite = sol.sprite.create("entities/items")
+      slot.sprite:set_animation(item:get_name())
+      slot.sprite:set_direction(variant - 1)
+    end
+  end
+
+  slot.counter = nil
+  if amount ~= nil then
+    -- Show a counter in this case.
+    slot.counter = sol.text_surface.create{
+      horizontal_alignment = "center",
+      vertical_alignment = "top",
+      text = amount,
+      font = (amount == maximum) and "green_digits" or "white_digits",
+    }
+  end
+
+  slot.variant, slot.amount, slot.maximum = variant, amount, maximum
+  return true
+end
+
+-- Draws the items that do not move on the surface of the grid.
+local function rebuild_grid_surface(grid)
+
+  grid.surface:clear()
+  grid.animated = {}
+  for k, slot in ipairs(grid.slots) do
+    if slot.sprite ~= nil then
+      local x = grid_margin + 32 * ((k - 1) % 7)
+      local y = grid_margin + 32 * math.floor((k - 1) / 7)
+      if slot.sprite:get_num_frames() > 1 then
+        grid.animated[#grid.animated + 1] = k
+      else
+        slot.sprite:draw(grid.surface, x, y)
+        if slot.counter ~= nil then
+          slot.counter:draw(grid.surface, x + 8, y)
+        end
+      end
+    end
+  end
+end
+
 function inventory_submenu:on_started()
 
   submenu.on_started(self)
 
-  self.cursor_sprite = sol.sprite.create("menus/pause_cursor")
-  self.sprites = {}
-  self.counters = {}
-  self.captions = {}
+  self.grid = get_grid(self.game)
+  self.cursor_sprite = self.grid.cursor_sprite
 
+  local changed = false
   for k = 1, #item_names do
-    -- Get the item, its possession state and amount.
     local item = self.game:get_item(item_names[k])
-    local variant = item:get_variant()
-
-    if variant > 0 then
-      if item:has_amount() then
-        -- Show a counter in this case.
-        local amount = item:get_amount()
-        local maximum = item:get_max_amount()
-
-        self.counters[k] = sol.text_surface.create{
-          horizontal_alignment = "center",
-          vertical_alignment = "top",
-          text = item:get_amount(),
-          font = (amount == maximum) and "green_digits" or "white_digits",
-        }
-      end
-
-      -- Initialize the sprite and the caption string.
-      self.sprites[k] = sol.sprite.create("entities/items")
-      self.sprites[k]:set_animation(item_names[k])
-      self.sprites[k]:set_direction(variant - 1)
+    if update_slot(self.grid.slots[k], item) then
+      changed = true
     end
   end
+  if changed then
+    rebuild_grid_surface(self.grid)
+  end
 
   -- Initialize the cursor
   local index = self.game:get_value("pause_inventory_last_item_index") or 0
@@ -196,31 +266,20 @@ function inventory_submenu:on_draw(dst_surface)
   self:draw_background(dst_surface)
   self:draw_caption(dst_surface)
 
-  -- Draw each inventory item.
+  -- Draw the inventory items.
   local quest_width, quest_height = dst_surface:get_size()
   local initial_x = quest_width / 2 - 96
   local initial_y = quest_height / 2 - 38
-  local y = initial_y
-  local k = 0
-
-  for i = 0, 3 do
-    local x = initial_x
-
-    for j = 0, 6 do
-      k = k + 1
-      if item_names[k] ~= nil then
-        local item = self.game:get_item(item_names[k])
-        if item:get_variant() > 0 then
-          -- The player has this item: draw it.
-          self.sprites[k]:draw(dst_surface, x, y)
-          if self.counters[k] ~= nil then
-            self.counters[k]:draw(dst_surface, x + 8, y)
-          end
-        end
-      end
-      x = x + 32
+  local grid = self.grid
+  grid.surface:draw(dst_surface, initial_x - grid_margin, initial_y - grid_margin)
+  for _, k in ipairs(grid.animated) do
+    local slot = grid.slots[k]
+    local x = initial_x + 32 * ((k - 1) % 7)
+    local y = initial_y + 32 * math.floor((k - 1) / 7)
+    slot.sprite:draw(dst_surface, x, y)
+    if slot.counter ~= nil then
+      slot.counter:draw(dst_surface, x + 8, y)
     end
-    y = y + 32
   end
 
   -- Draw the cursor.
@@ -1,9 +1,16 @@
 local submenu = require("menus/pause_submenu")
+local surface_cache = require("surface_cache")
 local map_submenu = submenu:new()
 
 local outside_world_size = { width = 2080, height = 3584 }
 local outside_world_minimap_size = { width = 225, height = 388 }
 
+-- Minimaps of dungeon floors already built, indexed by "dungeon_floor".
+-- A minimap is built again only when what it shows has changed.
+local floor_minimaps = {}
+local floor_minimap_keys = {}  -- Most recently used last.
+local max_floor_minimaps = 16
+
 function map_submenu:on_started()
 
   submenu.on_started(self)
@@ -43,12 +50,10 @@ function map_submenu:on_started()
     self.world_minimap_movement = nil
     self.world_minimap_visible_xy = {x = 0, y = 0}
     if self.game:has_item("world_map") then
-      self.world_minimap_img = sol.surface.create("menus/outside_world_map.png")
-      self.world_minimap_img:set_xy(center_x - 112, center_y - 61)
+      self.world_minimap_img = surface_cache.get(self, "menus/outside_world_map.png")
       self.world_minimap_visible_xy.y = math.min(outside_world_minimap_size.height - 133, math.max(0, hero_minimap_y - 65))
     else
-      self.world_minimap_img = sol.surface.create("menus/outside_world_clouds.png")
-      self.world_minimap_img:set_xy(center_x - 112, center_y - 61)
+      self.world_minimap_img = surface_cache.get(self, "menus/outside_world_clouds.png")
       self.world_minimap_visible_xy.y = 0
     end
 
@@ -60,9 +65,8 @@ function map_submenu:on_started()
     self:set_caption("map.caption.dungeon_name_" .. self.dungeon_index)
 
     -- Item icons.
-    self.dungeon_map_background_img = sol.surface.create("menus/dungeon_map_background.png")
-    self.dungeon_map_background_img:set_xy(center_x - 112, center_y - 61)
-    self.dungeon_map_icons_img = sol.surface.create("menus/dungeon_map_icons.png")
+    self.dungeon_map_background_img = surface_cache.get(self, "menus/dungeon_map_background.png")
+    self.dungeon_map_icons_img = surface_cache.get(self, "menus/dungeon_map_icons.png")
     self.small_keys_text = sol.text_surface.create{
       font = "white_digits",
       horizontal_alignment = "right",
@@ -72,8 +76,7 @@ function map_submenu:on_started()
     self.small_keys_text:set_xy(center_x - 20, center_y + 60)
 
     -- Floors.
-    self.dungeon_floors_img = sol.surface.create("floors.png", true)
-    self.dungeon_floors_img:set_xy(center_x - 160, center_y - 120)
+    self.dungeon_floors_img = surface_cache.get(self, "floors.png", true)
     self.hero_floor = self.game:get_map():get_floor()
     self.nb_floors = self.dungeon.highest_floor - self.dungeon.lowest_floor + 1
     self.nb_floors_displayed = math.min(7, self.nb_floors)
@@ -98,9 +101,22 @@ function map_submenu:on_started()
     self.up_arrow_sprite:set_xy(center_x - 71, center_y - 31)
     self.down_arrow_sprite:set_xy(center_x - 71, center_y - 64)
 
+    -- Hero.
+    self.hero_point_sprite = nil
+    if self.game:has_dungeon_compass() then
+      self.hero_point_sprite = sol.sprite.create("menus/hero_point")
+
+      local hero_absolute_x, hero_absolute_y = self.game:get_map():get_location()
+      local hero_map_x, hero_map_y = self.game:get_map():get_entity("hero"):get_position()
+      hero_absolute_x = hero_absolute_x + hero_map_x
+      hero_absolute_y = hero_absolute_y + hero_map_y
+
+      self.hero_x, self.hero_y = self:to_dungeon_minimap_coordinates(
+          hero_absolute_x, hero_absolute_y)
+      self.hero_x = self.hero_x - 1
+    end
+
     -- Minimap.
-    self.dungeon_map_img = sol.surface.create(123, 119)
-    self.dungeon_map_img:set_xy(center_x - 17, center_y - 54)
     self:load_dungeon_map_image()
   end
 end
@@ -207,10 +223,13 @@ end
 
 function map_submenu:draw_world_map(dst_surface)
 
+  local width, height = sol.video.get_quest_size()
+
   -- Draw the minimap.
+  -- Shared images are not moved with set_xy(): give the position here.
   self.world_minimap_img:draw_region(
       self.world_minimap_visible_xy.x, self.world_minimap_visible_xy.y, 225, 133,
-      dst_surface)
+      dst_surface, width / 2 - 112, height / 2 - 61)
 
   if self.game:has_item("world_map") then
     -- Draw the hero's position.
@@ -234,8 +253,10 @@ end
 
 function map_submenu:draw_dungeon_map(dst_surface)
 
+  local width, height = sol.video.get_quest_size()
+
   -- Background.
-  self.dungeon_map_background_img:draw(dst_surface)
+  self.dungeon_map_background_img:draw(dst_surface, width / 2 - 112, height / 2 - 61)
 
   -- Items.
   self:draw_dungeon_items(dst_surface)
@@ -244,11 +265,12 @@ function map_submenu:draw_dungeon_map(dst_surface)
   self:draw_dungeon_floors(dst_surface)
 
   -- The map itself.
+  local map_x, map_y = width / 2 - 17, height / 2 - 54
+  self.dungeon_map_img:draw(dst_surface, map_x, map_y)
   if self.hero_point_sprite ~= nil
       and self.selected_floor == self.hero_floor then
-    self.hero_point_sprite:draw(self.dungeon_map_img, self.hero_x, self.hero_y)
+    self.hero_point_sprite:draw(dst_surface, map_x + self.hero_x, map_y + self.hero_y)
   end
-  self.dungeon_map_img:draw(dst_surface)
 end
 
 function map_submenu:draw_dungeon_items(dst_surface)
@@ -295,7 +317,7 @@ function map_submenu:draw_dungeon_floors(dst_surface)
   local old_dst_y = dst_y
 
   self.dungeon_floors_img:draw_region(src_x, src_y, src_width, src_height,
-      dst_surface, dst_x, dst_y)
+      dst_surface, width / 2 - 160 + dst_x, height / 2 - 120 + dst_y)
 
   -- Draw the current floor with other colors.
   src_x = 64
@@ -303,7 +325,7 @@ function map_submenu:draw_dungeon_floors(dst_surface)
   src_height = 13
   dst_y = old_dst_y + (self.highest_floor_displayed - self.selected_floor) * 12
   self.dungeon_floors_img:draw_region(src_x, src_y, src_width, src_height,
-      dst_surface, dst_x, dst_y)
+      dst_surface, width / 2 - 160 + dst_x, height / 2 - 120 + dst_y)
 
   -- Draw the hero's icon if any.
   local lowest_floor_displayed = self.highest_floor_displayed - self.nb_floors_displayed + 1
@@ -360,31 +382,84 @@ function map_submenu:to_dungeon_minimap_coordinates(x, y)
   return x, y
 end
 
--- Rebuilds the minimap of the current floor of the dungeon.
+-- Returns a string that changes whenever the minimap of the selected floor
+-- has to be built again.
+function map_submenu:get_dungeon_map_state()
+
+  local state = {
+    self.game:has_dungeon_map() and "m" or "-",
+    self.game:has_dungeon_compass() and "c" or "-",
+  }
+
+  if self.game:has_dungeon_compass() then
+    local boss = self.dungeon.boss
+    if boss ~= nil
+        and boss.floor == self.selected_floor
+        and boss.savegame_variable ~= nil then
+      state[#state + 1] = self.game:get_value(boss.savegame_variable) and "1" or "0"
+    end
+
+    if self.dungeon.chests == nil then
+      -- Lazily load the chest information.
+      self:load_chests()
+    end
+    for _, chest in ipairs(self.dungeon.chests) do
+      if chest.floor == self.selected_floor
+          and chest.savegame_variable ~= nil then
+        state[#state + 1] = self.game:get_value(chest.savegame_variable) and "1" or "0"
+      end
+    end
+  end
+
+  return table.concat(state)
+end
+
+-- Sets the minimap of the selected floor of the dungeon,
+-- building it only if it is not already up to date.
 function map_submenu:load_dungeon_map_image()
 
-  self.dungeon_map_img:clear()
+  local key = self.dungeon_index .. "_" .. self.selected_floor
+  local state = self:get_dungeon_map_state()
+
+  local minimap = floor_minimaps[key]
+  if minimap == nil then
+    minimap = { surface = sol.surface.create(123, 119) }
+    floor_minimaps[key] = minimap
+  end
+
+  -- Keep the most recently used ones.
+  for i, other_key in ipairs(floor_minimap_keys) do
+    if other_key == key then
+      table.remove(floor_minimap_keys, i)
+      break
+    end
+  end
+  floor_minimap_keys[#floor_minimap_keys + 1] = key
+  if #floor_minimap_keys > max_floor_minimaps then
+    floor_minimaps[table.remove(floor_minimap_keys, 1)] = nil
+  end
+
+  if minimap.state ~= state then
+    self:build_dungeon_map_image(minimap.surface)
+    minimap.state = state
+  end
+  self.dungeon_map_img = minimap.surface
+end
+
+-- Draws the minimap of the selected floor of the dungeon:
+-- the image of the floor, the boss and the chests.
+function map_submenu:build_dungeon_map_image(dungeon_map_img)
+
+  dungeon_map_img:clear()
   if self.game:has_dungeon_map() then
     -- Load the image of this floor.
     local floor_map_img = sol.surface.create(
         "menus/dungeon_maps/map" .. self.dungeon_index ..
         "_" .. self.selected_floor .. ".png")
-    floor_map_img:draw(self.dungeon_map_img)
+    floor_map_img:draw(dungeon_map_img)
   end
 
   if self.game:has_dungeon_compass() then
-    -- Hero.
-    self.hero_point_sprite = sol.sprite.create("menus/hero_point")
-
-    local hero_absolute_x, hero_absolute_y = self.game:get_map():get_location()
-    local hero_map_x, hero_map_y = self.game:get_map():get_entity("hero"):get_position()
-    hero_absolute_x = hero_absolute_x + hero_map_x
-    hero_absolute_y = hero_absolute_y + hero_map_y
-
-    self.hero_x, self.hero_y = self:to_dungeon_minimap_coordinates(
-        hero_absolute_x, hero_absolute_y)
-    self.hero_x = self.hero_x - 1
-
     -- Boss.
     local boss = self.dungeon.boss
     if boss ~= nil
@@ -396,14 +471,10 @@ function map_submenu:load_dungeon_map_image()
       dst_x = dst_x - 4
       dst_y = dst_y - 4
       self.dungeon_map_icons_img:draw_region(78, 0, 8, 8,
-          self.dungeon_map_img, dst_x, dst_y)
+          dungeon_map_img, dst_x, dst_y)
     end
 
     -- Chests.
-    if self.dungeon.chests == nil then
-      -- Lazily load the chest information.
-      self:load_chests()
-    end
     for _, chest in ipairs(self.dungeon.chests) do
 
       if chest.floor == self.selected_floor
@@ -415,20 +486,65 @@ function map_submenu:load_dungeon_map_image()
         if chest.big then
           dst_x = dst_x - 3
           self.dungeon_map_icons_img:draw_region(78, 12, 6, 4,
-              self.dungeon_map_img, dst_x, dst_y)
+              dungeon_map_img, dst_x, dst_y)
         else
           dst_x = dst_x - 2
           self.dungeon_map_icons_img:draw_region(78, 8, 4, 4,
-              self.dungeon_map_img, dst_x, dst_y)
+              dungeon_map_img, dst_x, dst_y)
         end
       end
     end
   end
 end
 
+-- Determines the position of the chests of the current dungeon.
+function map_submenu:load_chests()
+
+  if not self:load_chests_from_index() then
+    -- No index: this happens when running the quest from the data directory
+    -- without building it.
+    self:parse_dungeon_chests()
+  end
+end
+
+-- Reads the position of the chests of all dungeons from the index
+-- generated at build time by tools/make_dungeon_index.lua.
+-- Returns false if there is no index.
+function map_submenu:load_chests_from_index()
+
+  local chunk = sol.main.load_file("dungeon_index.dat")
+  if chunk == nil then
+    return false
+  end
+
+  local dungeons = self.game.dungeons
+  for _, dungeon in pairs(dungeons) do
+    dungeon.chests = {}
+  end
+
+  local environment = {
+    chest = function(chest_properties)
+      local dungeon = dungeons[chest_properties.dungeon]
+      if dungeon ~= nil then
+        dungeon.chests[#dungeon.chests + 1] = {
+          floor = chest_properties.floor,
+          x = chest_properties.x,
+          y = chest_properties.y,
+          big = chest_properties.big,
+          savegame_variable = chest_properties.savegame_variable,
+        }
+      end
+    end,
+  }
+
+  setfenv(chunk, environment)
+  chunk()
+  return true
+end
+
 -- Parses all map data files of the current dungeon in order to determine the
 -- position of its chests.
-function map_submenu:load_chests()
+function map_submenu:parse_dungeon_chests()
 
   local dungeon = self.dungeon
   dungeon.chests = {}
@@ -1,4 +1,5 @@
 local submenu = require("menus/pause_submenu")
+local surface_cache = require("surface_cache")
 local quest_status_submenu = submenu:new()
 
 function quest_status_submenu:on_started()
@@ -78,13 +79,13 @@ function quest_status_submenu:on_started()
   end
 
   -- Pieces of heart.
-  local pieces_of_heart_img = sol.surface.create("menus/quest_status_pieces_of_heart.png")
+  local pieces_of_heart_img = surface_cache.get(self, "menus/quest_status_pieces_of_heart.png")
   local x = 51 * (self.game:get_value("i1030") or 0)
   pieces_of_heart_img:draw_region(x, 0, 51, 50, self.quest_items_surface, 101, 81)
   self.caption_text_keys[4] = "quest_status.caption.pieces_of_heart"
 
   -- Dungeons finished
-  local dungeons_img = sol.surface.create("menus/quest_status_dungeons.png")
+  local dungeons_img = surface_cache.get(self, "menus/quest_status_dungeons.png")
   local dst_positions = {
     { 209,  69 },
     { 232,  74 },
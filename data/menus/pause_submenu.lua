@@ -1,5 +1,6 @@
 -- Base class of each submenu.
 
+local surface_cache = require("surface_cache")
 local submenu = {}
 
 function submenu:new(game)
@@ -11,7 +12,8 @@ end
 
 function submenu:on_started()
 
-  self.background_surfaces = sol.surface.create("pause_submenus.png", true)
+  -- Only the submenus use this image: they can all change its opacity.
+  self.background_surfaces = surface_cache.get(self, "pause_submenus.png", true)
   self.background_surfaces:set_opacity(216)
   self.save_dialog_sprite = sol.sprite.create("menus/pause_save_dialog")
   self.save_dialog_state = 0
@@ -68,6 +70,12 @@ function submenu:on_started()
   self.game:set_custom_command_effect("attack", "save")
 end
 
+function submenu:on_finished()
+
+  -- Keep the images for the next time the pause menu is open.
+  surface_cache.release(self)
+end
+
 -- Sets the caption text.
 -- The caption text can have one or two lines, with 20 characters maximum for each line.
 -- If the text you want to display has two lines, use the '$' character to separate them.
@@ -1,18 +1,31 @@
 -- Savegame selection screen.
 
+local music_manager = require("music_manager")
+local savegame_summary = require("savegame_summary")
+local surface_cache = require("surface_cache")
 local savegame_menu = {}
 local cloud_width, cloud_height = 111, 88
+local language_delay = 400  -- Before applying a language chosen in the options.
 local last_joy_axis_move = { 0, 0 }
 
+-- Loads the images of the menu in advance.
+function savegame_menu.preload()
+
+  surface_cache.preload("menus/selection_menu_background.png")
+  surface_cache.preload("menus/selection_menu_cloud.png")
+  surface_cache.preload("menus/selection_menu_save_container.png")
+  surface_cache.preload("menus/selection_menu_option_container.png")
+end
+
 function savegame_menu:on_started()
 
   -- Create all graphic objects.
   self.surface = sol.surface.create(320, 240)
   self.background_color = { 104, 144, 240 }
-  self.background_img = sol.surface.create("menus/selection_menu_background.png")
-  self.cloud_img = sol.surface.create("menus/selection_menu_cloud.png")
-  self.save_container_img = sol.surface.create("menus/selection_menu_save_container.png")
-  self.option_container_img = sol.surface.create("menus/selection_menu_option_container.png")
+  self.background_img = surface_cache.get(self, "menus/selection_menu_background.png")
+  self.cloud_img = surface_cache.get(self, "menus/selection_menu_cloud.png")
+  self.save_container_img = surface_cache.get(self, "menus/selection_menu_save_container.png")
+  self.option_container_img = surface_cache.get(self, "menus/selection_menu_option_container.png")
   local dialog_font, dialog_font_size = sol.language.get_dialog_font()
   local menu_font, menu_font_size = sol.language.get_menu_font()
   self.option1_text = sol.text_surface.create{
@@ -57,13 +70,19 @@ function savegame_menu:on_started()
 
   -- Run the menu.
   self:read_savegames()
-  sol.audio.play_music("game_over")
+  music_manager.play("game_over")
   self:init_phase_select_file()
 
   -- Show an opening transition.
   self.surface:fade_in()
 end
 
+function savegame_menu:on_finished()
+
+  self:apply_language()
+  surface_cache.release(self)
+end
+
 function savegame_menu:on_key_pressed(key)
 
   local handled = false
@@ -254,26 +273,36 @@ function savegame_menu:read_savegames()
   for i = 1, 3 do
     local slot = {}
     slot.file_name = "save" .. i .. ".dat"
-    slot.savegame = sol.game.load(slot.file_name)
-    slot.number_img = sol.surface.create("menus/selection_menu_save" .. i .. ".png")
+    slot.number_img = surface_cache.get(self, "menus/selection_menu_save" .. i .. ".png")
 
     slot.player_name_text = sol.text_surface.create{
       font = font,
       font_size = font_size,
     }
     if sol.game.exists(slot.file_name) then
-      -- Existing file.
-      if slot.savegame:get_ability("tunic") == 0 then
-        -- Savegame not fully initialized (created with Solarus 0.9).
-        slot.savegame:set_ability("tunic", 1)
-        slot.savegame:get_item("rupee_bag"):set_variant(1)
+      -- Existing file: only read its summary.
+      local summary = savegame_summary.read(slot.file_name)
+      if summary == nil then
+        -- No summary yet: load the full savegame once to create it.
+        local savegame = self:load_savegame(slot)
+        savegame_summary.write(savegame, slot.file_name)
+        summary = {
+          player_name = savegame:get_value("player_name"),
+          life = savegame:get_life(),
+          max_life = savegame:get_max_life(),
+        }
       end
 
-      slot.player_name_text:set_text(slot.savegame:get_value("player_name"))
+      slot.player_name_text:set_text(summary.player_name)
 
       -- Hearts.
       local hearts_class = require("hud/hearts")
-      slot.hearts_view = hearts_class:new(slot.savegame)
+      slot.hearts_view = hearts_class:new({
+        get_life = function() return summary.life end,
+        get_max_life = function() return summary.max_life end,
+        is_started = function() return false end,
+        is_hud_enabled = function() return false end,
+      })
       slot.hearts_view:on_started()
     else
       -- New file.
@@ -285,6 +314,21 @@ function savegame_menu:read_savegames()
   end
 end
 
+-- Returns the savegame of a slot, loading it if necessary.
+function savegame_menu:load_savegame(slot)
+
+  if slot.savegame == nil then
+    slot.savegame = savegame_summary.load(slot.file_name)
+    if sol.game.exists(slot.file_name)
+        and slot.savegame:get_ability("tunic") == 0 then
+      -- Savegame not fully initialized (created with Solarus 0.9).
+      slot.savegame:set_ability("tunic", 1)
+      slot.savegame:get_item("rupee_bag"):set_variant(1)
+    end
+  end
+  return slot.savegame
+end
+
 function savegame_menu:set_bottom_buttons(key1, key2)
 
   if key1 ~= nil then
@@ -391,7 +435,7 @@ function savegame_menu:key_pressed_phase_select_file(key)
         self.surface:fade_out()
         sol.timer.start(self, 700, function()
           sol.menu.stop(self)
-	  sol.main:start_savegame(slot.savegame)
+	  sol.main:start_savegame(self:load_savegame(slot))
         end)
       else
         -- It's a new savegame: choose the player's name.
@@ -538,6 +582,7 @@ function savegame_menu:key_pressed_phase_confirm_erase(key)
       sol.audio.play_sound("boss_killed")
       local slot = self.slots[self.save_number_to_erase]
       sol.game.delete(slot.file_name)
+      savegame_summary.delete(slot.file_name)
       self.cursor_position = self.save_number_to_erase
       self:read_savegames()
       self:init_phase_select_file()
@@ -605,7 +650,7 @@ function savegame_menu:init_phase_options()
     {
       name = "music_volume",
       values = { 0, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100},
-      initial_value = math.floor((sol.audio.get_music_volume() + 5) / 10) * 10
+      initial_value = math.floor((music_manager.get_volume() + 5) / 10) * 10
     },
     {
       name = "sound_volume",
@@ -677,6 +722,7 @@ function savegame_menu:key_pressed_phase_options(key)
 	self.modifying_option = true
       else
 	sol.audio.play_sound("danger")
+	self:apply_language()
 	option.label_text:set_color{255, 255, 0}
 	option.value_text:set_color{255, 255, 255}
 	self.left_arrow_sprite:set_frame(0)
@@ -806,11 +852,19 @@ function savegame_menu:set_option_value(option, index)
     local value = option.values[index]
 
     if option.name == "language" then
+      local font, font_size = sol.language.get_menu_font(value)
+      option.value_text:set_font(font)
+      option.value_text:set_font_size(font_size)
       option.value_text:set_text(sol.language.get_language_name(value))
-      if value ~= sol.language.get_language() then
-	sol.language.set_language(value)
-	self:reload_options_strings()
+      -- Changing the language parses all its strings and dialogs:
+      -- only do it when the player stays on a language.
+      self.pending_language = value
+      if self.language_timer ~= nil then
+        self.language_timer:stop()
       end
+      self.language_timer = sol.timer.start(self, language_delay, function()
+        self:apply_language()
+      end)
 
     elseif option.name == "video_mode" then
       option.value_text:set_text(value)
@@ -818,7 +872,7 @@ function savegame_menu:set_option_value(option, index)
 
     elseif option.name == "music_volume" then
       option.value_text:set_text(value)
-      sol.audio.set_music_volume(value)
+      music_manager.set_volume(value)
 
     elseif option.name == "sound_volume" then
       option.value_text:set_text(value)
@@ -827,6 +881,22 @@ function savegame_menu:set_option_value(option, index)
   end
 end
 
+-- Changes the language to the one chosen in the options, if any.
+function savegame_menu:apply_language()
+
+  if self.language_timer ~= nil then
+    self.language_timer:stop()
+    self.language_timer = nil
+  end
+
+  local language = self.pending_language
+  self.pending_language = nil
+  if language ~= nil and language ~= sol.language.get_language() then
+    sol.language.set_language(language)
+    self:reload_options_strings()
+  end
+end
+
 -- Reloads all strings displayed on the menu.
 -- This function is called when the language has just been changed.
 function savegame_menu:reload_options_strings()
@@ -876,7 +946,7 @@ function savegame_menu:init_phase_choose_name()
     font_size = font_size,
   }
   self.letter_cursor = { x = 0, y = 0 }
-  self.letters_img = sol.surface.create("menus/selection_menu_letters.png")
+  self.letters_img = surface_cache.get(self, "menus/selection_menu_letters.png")
   self.name_arrow_sprite = sol.sprite.create("menus/arrow")
   self.name_arrow_sprite:set_direction(0)
   self.can_add_letter_player_name = true
@@ -1021,7 +1091,7 @@ function savegame_menu:validate_player_name()
 
   sol.audio.play_sound("ok")
 
-  local savegame = self.slots[self.cursor_position].savegame
+  local savegame = self:load_savegame(self.slots[self.cursor_position])
   self:set_initial_values(savegame)
   savegame:save()
   self:read_savegames()
@@ -1,7 +1,34 @@
 -- Title screen of the game.
 
+local surface_cache = require("surface_cache")
 local title_screen = {}
 
+-- The background depends on the hour of the day.
+local function get_time_of_day()
+
+  local hours = tonumber(os.date("%H"))
+  if hours >= 8 and hours < 18 then
+    return "daylight"
+  elseif hours >= 18 and hours < 20 then
+    return "sunset"
+  end
+  return "night"
+end
+
+-- Loads the images of the title screen in advance.
+function title_screen.preload()
+
+  local time_of_day = get_time_of_day()
+  if sol.language.get_language() ~= nil then
+    -- Not known yet the first time the game is launched.
+    surface_cache.preload("title_screen_initialization.png", true)
+  end
+  surface_cache.preload("menus/title_" .. time_of_day .. "_background.png")
+  surface_cache.preload("menus/title_" .. time_of_day .. "_clouds.png")
+  surface_cache.preload("menus/title_logo.png")
+  surface_cache.preload("menus/title_borders.png")
+end
+
 function title_screen:on_started()
 
   -- black screen during 0.3 seconds
@@ -11,9 +38,6 @@ function title_screen:on_started()
   sol.timer.start(self, 300, function()
     self:phase_zs_presents()
   end)
-
-  -- use these 0.3 seconds to preload all sound effects
-  sol.audio.preload_sounds()
 end
 
 function title_screen:phase_zs_presents()
@@ -22,7 +46,7 @@ function title_screen:phase_zs_presents()
   self.phase = "zs_presents"
 
   self.zs_presents_img =
-      sol.surface.create("title_screen_initialization.png", true)
+      surface_cache.get(self, "title_screen_initialization.png", true)
 
   local width, height = self.zs_presents_img:get_size()
   self.zs_presents_pos = { 160 - width / 2, 120 - height / 2 }
@@ -45,23 +69,15 @@ function title_screen:phase_title()
   sol.audio.play_music("title_screen")
 
   -- show a background that depends on the hour of the day
-  local hours = tonumber(os.date("%H"))
-  local time_of_day
-  if hours >= 8 and hours < 18 then
-    time_of_day = "daylight"
-  elseif hours >= 18 and hours < 20 then
-    time_of_day = "sunset"
-  else
-    time_of_day = "night"
-  end
+  local time_of_day = get_time_of_day()
 
   -- create all images
-  self.background_img = sol.surface.create("menus/title_" .. time_of_day
+  self.background_img = surface_cache.get(self, "menus/title_" .. time_of_day
       .. "_background.png")
-  self.clouds_img = sol.surface.create("menus/title_" .. time_of_day
+  self.clouds_img = surface_cache.get(self, "menus/title_" .. time_of_day
       .. "_clouds.png")
-  self.logo_img = sol.surface.create("menus/title_logo.png")
-  self.borders_img = sol.surface.create("menus/title_borders.png")
+  self.logo_img = surface_cache.get(self, "menus/title_logo.png")
+  self.borders_img = surface_cache.get(self, "menus/title_borders.png")
 
   local dialog_font, dialog_font_size = sol.language.get_dialog_font()
   local menu_font, menu_font_size = sol.language.get_menu_font()
@@ -85,11 +101,11 @@ function title_screen:phase_title()
   -- set up the appearance of images and texts
   sol.timer.start(self, 5000, function()
     sol.audio.play_sound("ok")
-    self.dx_img = sol.surface.create("menus/title_dx.png")
+    self.dx_img = surface_cache.get(self, "menus/title_dx.png")
   end)
 
   sol.timer.start(self, 6000, function()
-    self.star_img = sol.surface.create("menus/title_star.png")
+    self.star_img = surface_cache.get(self, "menus/title_star.png")
   end)
 
   self.show_press_space = false
@@ -122,6 +138,10 @@ function title_screen:phase_title()
   sol.timer.start(self, 2000, function()
     self.allow_skip = true
   end)
+
+  if self.on_ready ~= nil then
+    self:on_ready()
+  end
 end
 
 function title_screen:on_draw(dst_surface)
@@ -229,6 +249,8 @@ end
 function title_screen:finish_title()
 
   sol.audio.stop_music()
+  -- main.lua sets on_finished(): release the images here.
+  surface_cache.release(self)
   sol.menu.stop(self)
 end
 
@@ -0,0 +1,173 @@
+-- Fades the music out and in instead of cutting it.
+--
+-- The engine already streams OGG musics by small buffers and opens a music
+-- only when it is played: there is no decoder to keep ready from Lua.
+-- What this script improves is the transition between two musics:
+-- - music_manager.play(music_id) fades out the current music,
+--   then starts the new one and fades it in.
+-- - When the hero takes a teletransporter to a map of the same world with
+--   another music, the music fades out during the transition and the
+--   new one fades in when the map starts.
+--
+-- The world and music of destination maps are read from the properties of
+-- their data file the first time and kept.
+--
+-- The music volume chosen by the player must be changed with
+-- music_manager.set_volume(), so that a fade does not lose it.
+--
+-- Usage:
+-- local music_manager = require("music_manager")
+-- music_manager.initialize()
+
+local music_manager = {
+  fade_out_delay = 400,
+  fade_in_delay = 600,
+}
+
+local step_delay = 20
+local volume = nil          -- Volume chosen by the player.
+local fade_timer = nil
+local faded_out = false     -- Waiting for the music of the next map.
+
+-- World and music of maps, indexed by map id, or false if unknown.
+local maps_info = {}
+
+function music_manager.get_volume()
+
+  if volume == nil then
+    volume = sol.audio.get_music_volume()
+  end
+  return volume
+end
+
+function music_manager.set_volume(new_volume)
+
+  volume = new_volume
+  if fade_timer == nil and not faded_out then
+    sol.audio.set_music_volume(volume)
+  end
+end
+
+-- Stops any fade and restores the volume of the player.
+function music_manager.stop_fading()
+
+  if fade_timer ~= nil then
+    fade_timer:stop()
+    fade_timer = nil
+  end
+  faded_out = false
+  sol.audio.set_music_volume(music_manager.get_volume())
+end
+
+-- Changes the music volume progressively.
+local function fade(target_volume, delay, callback)
+
+  if fade_timer ~= nil then
+    fade_timer:stop()
+  end
+
+  local initial_volume = sol.audio.get_music_volume()
+  local num_steps = math.max(1, math.floor(delay / step_delay))
+  local step = 0
+  fade_timer = sol.timer.start(sol.main, step_delay, function()
+    step = step + 1
+    sol.audio.set_music_volume(math.floor(initial_volume
+        + (target_volume - initial_volume) * step / num_steps + 0.5))
+    if step < num_steps then
+      return true  -- Repeat the timer.
+    end
+    fade_timer = nil
+    if callback ~= nil then
+      callback()
+    end
+  end)
+end
+
+-- Plays a music after fading out the current one.
+function music_manager.play(music_id)
+
+  local current_music = sol.audio.get_music()
+  if music_id == current_music then
+    return
+  end
+
+  music_manager.get_volume()
+  local function start_music()
+    sol.audio.set_music_volume(0)
+    sol.audio.play_music(music_id)
+    fade(volume, music_manager.fade_in_delay)
+  end
+
+  faded_out = false
+  if current_music == nil then
+    start_music()
+  else
+    fade(0, music_manager.fade_out_delay, start_music)
+  end
+end
+
+-- Returns the world and the music of a map, or nil if they are unknown.
+-- Only the properties at the beginning of the data file are parsed:
+-- maps precompiled to bytecode are unknown.
+local function get_map_info(map_id)
+
+  local info = maps_info[map_id]
+  if info == nil then
+    info = false
+    local file = sol.file.open("maps/" .. map_id .. ".dat")
+    if file ~= nil then
+      local text = file:read(1024) or ""
+      file:close()
+      local properties = text:match("^%s*properties(%b{})")
+      local chunk = properties and loadstring("return " .. properties)
+      if chunk ~= nil then
+        setfenv(chunk, {})
+        local success, result = pcall(chunk)
+        if success and type(result) == "table" then
+          info = { world = result.world, music = result.music }
+        end
+      end
+    end
+    maps_info[map_id] = info
+  end
+  return info or nil
+end
+
+-- Sets up the fades of teletransporters.
+function music_manager.initialize()
+
+  local teletransporter_meta = sol.main.get_metatable("teletransporter")
+
+  function teletransporter_meta:on_activated()
+
+    local map = self:get_map()
+    local destination_map_id = self:get_destination_map()
+    if destination_map_id == nil or destination_map_id == map:get_id() then
+      return
+    end
+
+    local info = get_map_info(destination_map_id)
+    if info == nil
+        or info.music == nil
+        or info.music == "same"
+        or info.music == sol.audio.get_music()
+        or info.world ~= map:get_world() then
+      return
+    end
+
+    music_manager.get_volume()
+    faded_out = true
+    fade(0, music_manager.fade_out_delay)
+  end
+end
+
+-- Called when a new map starts: fades in its music if needed.
+function music_manager.on_map_changed()
+
+  if faded_out then
+    faded_out = false
+    fade(music_manager.get_volume(), music_manager.fade_in_delay)
+  end
+end
+
+return music_manager
@@ -1,3 +1,6 @@
+local memory_tracker = require("memory_tracker")
+local music_manager = require("music_manager")
+
 return function(game)
 
   -- Include the various game features.
@@ -7,6 +10,8 @@ return function(game)
   require("menus/dialog_box")(game)
   require("menus/game_over")(game)
   require("hud/hud")(game)
+  require("prefetch")(game)
+  require("input_recorder")(game)
 
   -- Useful functions for this specific quest.
 
@@ -15,6 +20,12 @@ return function(game)
     -- Set up the dialog box and the HUD.
     self:initialize_dialog_box()
     self:initialize_hud()
+
+    -- Count the play time from now (see quest_manager.lua).
+    -- The game also restarts after a game over.
+    if self.play_time_start == nil then
+      self.play_time_start = sol.main.get_elapsed_time()
+    end
   end
 
   function game:on_finished()
@@ -29,6 +40,15 @@ return function(game)
 
     -- Notify the hud.
     self:hud_on_map_changed(map)
+
+    -- Fade in the music if it changed.
+    music_manager.on_map_changed()
+
+    -- Prepare the next maps.
+    self:prefetch_neighbour_maps(map)
+
+    -- Warn if the quest keeps too much memory.
+    memory_tracker:on_map_changed(map)
   end
 
   function game:on_paused()
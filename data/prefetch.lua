@@ -0,0 +1,129 @@
+-- Loads in advance the sprites of the maps reachable from the current map.
+--
+-- The engine keeps the animations (and images) of a sprite loaded once it
+-- was created, so creating the sprites of the neighbour maps while the hero
+-- is still on the current map makes the next map start faster.
+-- One sprite is created at each step to avoid slowdowns.
+--
+-- The neighbours of each map come from map_neighbours.dat,
+-- generated at build time by tools/make_map_neighbours.lua.
+-- Without this file, nothing is loaded in advance.
+
+-- Neighbours and sprites of each map, indexed by map id,
+-- or false if there is no index.
+local maps_info = nil
+
+-- Sprites already created, indexed by id.
+local loaded_sprites = {}
+local num_loaded_sprites = 0
+
+-- Loaded sprites are never freed: don't load more than this.
+local max_loaded_sprites = 300
+local first_step_delay = 1000
+local step_delay = 50
+
+local function get_map_info(map_id)
+
+  local info = maps_info[map_id]
+  if info == nil then
+    info = { neighbours = {}, sprites = {} }
+    maps_info[map_id] = info
+  end
+  return info
+end
+
+local function load_maps_info()
+
+  local chunk = sol.main.load_file("map_neighbours.dat")
+  if chunk == nil then
+    maps_info = false
+    return
+  end
+
+  maps_info = {}
+  setfenv(chunk, {
+    neighbour = function(properties)
+      local neighbours = get_map_info(properties.map).neighbours
+      neighbours[#neighbours + 1] = properties.destination_map
+    end,
+    sprite = function(properties)
+      local sprites = get_map_info(properties.map).sprites
+      sprites[#sprites + 1] = properties.id
+    end,
+  })
+  chunk()
+end
+
+return function(game)
+
+  -- Starts loading the sprites of the maps reachable from this map.
+  -- The work stops when the map stops.
+  function game:prefetch_neighbour_maps(map)
+
+    if maps_info == nil then
+      load_maps_info()
+    end
+    if not maps_info then
+      return
+    end
+
+    local info = maps_info[map:get_id()]
+    if info == nil then
+      return
+    end
+
+    -- The sprites of the current map are already loaded.
+    for _, sprite_id in ipairs(info.sprites) do
+      if not loaded_sprites[sprite_id] then
+        loaded_sprites[sprite_id] = true
+        num_loaded_sprites = num_loaded_sprites + 1
+      end
+    end
+
+    local sprites_to_load = {}
+    for _, neighbour_id in ipairs(info.neighbours) do
+      local neighbour_info = maps_info[neighbour_id]
+      if neighbour_info ~= nil then
+        for _, sprite_id in ipairs(neighbour_info.sprites) do
+          if not loaded_sprites[sprite_id] then
+            sprites_to_load[#sprites_to_load + 1] = sprite_id
+          end
+        end
+      end
+    end
+
+    if #sprites_to_load == 0 then
+      return
+    end
+
+    local index = 1
+    local function load_next_sprite()
+
+      if num_loaded_sprites >= max_loaded_sprites then
+        return false
+      end
+
+      -- Find the next sprite not loaded yet (another neighbour may have
+      -- the same one).
+      local sprite_id = sprites_to_load[index]
+      while sprite_id ~= nil and loaded_sprites[sprite_id] do
+        index = index + 1
+        sprite_id = sprites_to_load[index]
+      end
+      if sprite_id == nil then
+        return false
+      end
+
+      sol.sprite.create(sprite_id)
+      loaded_sprites[sprite_id] = true
+      num_loaded_sprites = num_loaded_sprites + 1
+      index = index + 1
+      return true  -- Repeat the timer.
+    end
+
+    -- Let the map start first.
+    sol.timer.start(map, first_step_delay, function()
+      sol.timer.start(map, step_delay, load_next_sprite)
+    end)
+  end
+end
@@ -0,0 +1,390 @@
+-- A profiling overlay that can be enabled with F10 in debug mode,
+-- or from the console with profiler:toggle().
+--
+-- It shows the real duration of each frame, the processor time spent
+-- updating, drawing and collecting garbage, the number of updates per
+-- frame, the memory used by Lua and how it changes, the number of active
+-- timers for each kind of owner, and a graph of the last frame durations.
+--
+-- Updates are measured until the profiler's on_update() and drawing
+-- until its on_draw(), so the menus started after it count in the next
+-- phase. While the profiler is enabled, the garbage collector runs at the
+-- end of each frame, for as much memory as the frame allocated, so that
+-- its time can be measured: the automatic steps run inside allocations.
+--
+-- Only the timers started while the profiler is enabled are counted.
+-- A timer stops being counted when it ends, when it is stopped, or when
+-- its context (map, entity, menu...) no longer exists. Timers of other
+-- tables, like the HUD elements, run until they end or are stopped.
+--
+-- While it is enabled, one record is kept per frame for the current map.
+-- profiler:dump_csv() writes the records of the current map to
+-- profile_<map_id>.csv in the write directory. If profiler.dump_on_map_change
+-- is true, this is also done each time the map changes.
+
+local real_clock = require("real_clock")
+
+local profiler = {
+  enabled = false,
+  dump_on_map_change = false,
+  color = { 64, 64, 64 },          -- Background color of the overlay.
+  graph_color = { 64, 192, 64 },   -- Color of the frame times.
+  slow_color = { 224, 64, 64 },    -- Color of frames that missed a refresh.
+  slow_frame_ms = 1.5 * 1000 / 60, -- Real duration of a frame that missed a refresh at 60 Hz.
+  max_records = 60 * 60 * 5,       -- Records kept for a map (5 minutes).
+  num_graph_frames = 100,
+  text_delay = 250,                -- Refresh delay of the texts.
+}
+
+local text_surfaces = {}
+for i = 1, 4 do
+  text_surfaces[i] = sol.text_surface.create{
+    font = "minecraftia",
+    font_size = 8,
+  }
+end
+
+local get_type = sol.main.get_type or type
+
+-- Frame being measured.
+local frame_start_time = nil  -- Real time when the previous frame ended.
+local phase_clock = nil       -- Processor time when the previous phase ended.
+local frame_update_ms = 0
+local frame_draw_ms = 0
+local frame_num_updates = 0
+local frame_num_timers = 0  -- Active timers at the end of the frame.
+local last_lua_kb = 0
+
+-- Processor times since the last text refresh.
+local text_sums = { update_ms = 0, draw_ms = 0, gc_ms = 0, num_frames = 0 }
+
+-- Last frame times in milliseconds (circular buffer).
+local frame_times = {}
+local frame_index = 0
+
+-- Owner type and context of each active timer.
+local timer_owner_types = setmetatable({}, { __mode = "k" })
+local timer_contexts = setmetatable({}, { __mode = "kv" })
+local timer_menus = setmetatable({}, { __mode = "k" })  -- Timers of started menus.
+local last_text_time = 0
+
+-- Records of the current map.
+local records = {}
+local records_map_id = nil
+
+local function forget_timer(timer)
+  timer_owner_types[timer] = nil
+  timer_contexts[timer] = nil
+  timer_menus[timer] = nil
+end
+
+-- Returns whether a timer can still run, given its context.
+local function is_context_alive(timer, context)
+
+  local context_type = get_type(context)
+  local game = sol.main.game
+  if context == sol.main then
+    return true
+  elseif context_type == "map" then
+    return game ~= nil and game:get_map() == context
+  elseif context_type == "game" then
+    return game == context
+  elseif context_type == "item" then
+    return game ~= nil and context:get_game() == game
+  elseif context_type == "table" then
+    -- The engine only removes the timers of a table when it is a menu
+    -- that stops.
+    return not timer_menus[timer] or sol.menu.is_started(context)
+  elseif type(context.exists) == "function" then
+    return context:exists()  -- Map entity.
+  end
+  return true
+end
+
+-- Counts the timers started while the profiler is enabled,
+-- until they end.
+local start_timer = sol.timer.start
+function sol.timer.start(context, delay, callback)
+
+  if not profiler.enabled then
+    return start_timer(context, delay, callback)
+  end
+
+  local owner_type = "default"
+  if type(context) == "number" then
+    -- No context: the current map, or sol.main without a game.
+    delay, callback = context, delay
+    local game = sol.main.game
+    context = game ~= nil and game:get_map() or sol.main
+  else
+    owner_type = get_type(context)
+  end
+
+  local timer
+  local finished = false
+  timer = start_timer(context, delay, function(...)
+    local repeat_timer = callback(...)
+    if not repeat_timer then
+      finished = true
+      if timer ~= nil then
+        forget_timer(timer)
+      end
+    end
+    return repeat_timer
+  end)
+  if timer ~= nil and not finished then
+    timer_owner_types[timer] = owner_type
+    timer_contexts[timer] = context
+    if type(context) == "table" and sol.menu.is_started(context) then
+      timer_menus[timer] = true
+    end
+  end
+  return timer
+end
+
+local timer_meta = sol.main.get_metatable("timer")
+local stop_timer = timer_meta.stop
+function timer_meta:stop()
+  forget_timer(self)
+  return stop_timer(self)
+end
+
+local stop_all_timers = sol.timer.stop_all
+function sol.timer.stop_all(context)
+
+  for timer, timer_context in pairs(timer_contexts) do
+    if timer_context == context then
+      forget_timer(timer)
+    end
+  end
+  return stop_all_timers(context)
+end
+
+-- Returns the number of active timers of each owner type, and in total.
+local function count_timers()
+
+  local counts = {}
+  local total = 0
+  for timer, owner_type in pairs(timer_owner_types) do
+    local context = timer_contexts[timer]
+    if context == nil or not is_context_alive(timer, context) then
+      forget_timer(timer)
+    else
+      counts[owner_type] = (counts[owner_type] or 0) + 1
+      total = total + 1
+    end
+  end
+  return counts, total
+end
+
+function profiler:toggle()
+
+  if self.enabled then
+    sol.menu.stop(self)
+  else
+    sol.menu.start(sol.main, self)
+  end
+end
+
+function profiler:on_started()
+
+  self.enabled = true
+  frame_start_time = nil
+  phase_clock = nil
+  frame_times = {}
+  frame_index = 0
+  last_text_time = sol.main.get_elapsed_time()
+  last_lua_kb = collectgarbage("count")
+  records = {}
+  records_map_id = nil
+  collectgarbage("stop")  -- Collected at the end of each frame (see end_frame()).
+end
+
+function profiler:on_finished()
+
+  self.enabled = false
+  collectgarbage("restart")
+end
+
+function profiler:on_update()
+
+  frame_num_updates = frame_num_updates + 1
+  local clock = os.clock()
+  if phase_clock ~= nil then
+    frame_update_ms = frame_update_ms + (clock - phase_clock) * 1000
+  end
+  phase_clock = clock
+end
+
+local function get_map_id()
+
+  local game = sol.main.game
+  if game ~= nil and game:get_map() ~= nil then
+    return game:get_map():get_id()
+  end
+  return nil
+end
+
+-- Collects the garbage allocated during the frame.
+-- Returns the processor time spent.
+local function collect_garbage()
+
+  local allocated_kb = collectgarbage("count") - last_lua_kb
+  if allocated_kb <= 0 then
+    return 0
+  end
+  local clock = os.clock()
+  collectgarbage("step", allocated_kb)
+  collectgarbage("stop")  -- A step restarts the automatic collector.
+  return (os.clock() - clock) * 1000
+end
+
+-- Ends the current frame and records it.
+local function end_frame()
+
+  local clock = os.clock()
+  if phase_clock ~= nil then
+    frame_draw_ms = (clock - phase_clock) * 1000
+  end
+  local gc_ms = collect_garbage()
+
+  local now = real_clock.get_time()
+  if frame_start_time == nil then
+    frame_start_time = now
+    frame_update_ms = 0
+    frame_num_updates = 0
+    frame_num_timers = 0
+    last_lua_kb = collectgarbage("count")
+    return
+  end
+
+  local frame_ms = now - frame_start_time
+  frame_start_time = now
+  frame_index = frame_index % profiler.num_graph_frames + 1
+  frame_times[frame_index] = frame_ms
+
+  local lua_kb = collectgarbage("count")
+  local lua_kb_delta = lua_kb - last_lua_kb
+  last_lua_kb = lua_kb
+  local _, num_timers = count_timers()
+  frame_num_timers = num_timers
+
+  local map_id = get_map_id()
+  if map_id ~= records_map_id then
+    if profiler.dump_on_map_change then
+      profiler:dump_csv()
+    end
+    records = {}
+    records_map_id = map_id
+  end
+  if #records < profiler.max_records then
+    records[#records + 1] = {
+      sol.main.get_elapsed_time(),
+      frame_ms,
+      frame_update_ms,
+      frame_draw_ms,
+      gc_ms,
+      frame_num_updates,
+      lua_kb,
+      lua_kb_delta,
+      frame_num_timers,
+    }
+  end
+
+  text_sums.update_ms = text_sums.update_ms + frame_update_ms
+  text_sums.draw_ms = text_sums.draw_ms + frame_draw_ms
+  text_sums.gc_ms = text_sums.gc_ms + gc_ms
+  text_sums.num_frames = text_sums.num_frames + 1
+
+  frame_update_ms = 0
+  frame_num_updates = 0
+end
+
+local function rebuild_texts()
+
+  local sum, max, num_frames = 0, 0, #frame_times
+  for _, frame_ms in ipairs(frame_times) do
+    sum = sum + frame_ms
+    max = math.max(max, frame_ms)
+  end
+  local last = records[#records]
+  local updates = last and last[6] or 0
+  local lua_kb_delta = last and last[8] or 0
+
+  text_surfaces[1]:set_text(string.format("frame %.1f ms (max %.1f), %d updates",
+      num_frames > 0 and sum / num_frames or 0, max, updates))
+  local num_text_frames = math.max(text_sums.num_frames, 1)
+  text_surfaces[2]:set_text(string.format("cpu: update %.1f ms, draw %.1f ms, gc %.2f ms",
+      text_sums.update_ms / num_text_frames, text_sums.draw_ms / num_text_frames,
+      text_sums.gc_ms / num_text_frames))
+  text_sums = { update_ms = 0, draw_ms = 0, gc_ms = 0, num_frames = 0 }
+  text_surfaces[3]:set_text(string.format("lua %d KB (%+.1f KB)",
+      last_lua_kb, lua_kb_delta))
+
+  -- Active timers.
+  local timer_counts = count_timers()
+  local owner_types = {}
+  for owner_type in pairs(timer_counts) do
+    owner_types[#owner_types + 1] = owner_type
+  end
+  table.sort(owner_types)
+  local counts = {}
+  for _, owner_type in ipairs(owner_types) do
+    counts[#counts + 1] = string.format("%s %d",
+        owner_type, timer_counts[owner_type])
+  end
+  text_surfaces[4]:set_text("timers: " .. table.concat(counts, ", "))
+
+  last_text_time = sol.main.get_elapsed_time()
+end
+
+function profiler:on_draw(dst_surface)
+
+  end_frame()
+  if sol.main.get_elapsed_time() >= last_text_time + self.text_delay then
+    rebuild_texts()
+  end
+
+  local width = dst_surface:get_size()
+  dst_surface:fill_color(self.color, 0, 0, width, 74)
+  for i, text_surface in ipairs(text_surfaces) do
+    text_surface:draw(dst_surface, 4, i * 10 - 4)
+  end
+
+  -- Graph of the last frames, oldest first, 1 pixel per millisecond.
+  local num_frames = #frame_times
+  for i = 1, num_frames do
+    local frame_ms = frame_times[(frame_index + i - 1) % num_frames + 1]
+    local height = math.min(math.ceil(frame_ms), 28)
+    local color = frame_ms > self.slow_frame_ms and self.slow_color or self.graph_color
+    dst_surface:fill_color(color, 4 + (i - 1) * 2, 72 - height, 2, height)
+  end
+
+  -- The overlay itself is not counted in the next update.
+  phase_clock = os.clock()
+end
+
+-- Writes the records of the current map to a CSV file in the write
+-- directory. Returns the file name, or nil if there is nothing to write.
+function profiler:dump_csv(file_name)
+
+  if #records == 0 then
+    return nil
+  end
+
+  file_name = file_name or ("profile_" .. (records_map_id or "none") .. ".csv")
+  local file = sol.file.open(file_name, "w")
+  if file == nil then
+    return nil
+  end
+  file:write("time_ms,map,frame_ms,update_ms,draw_ms,gc_ms,updates,lua_kb,lua_kb_delta,active_timers\n")
+  for _, record in ipairs(records) do
+    file:write(string.format("%d,%s,%.3f,%.3f,%.3f,%.3f,%d,%.1f,%.1f,%d\n",
+        record[1], records_map_id or "", record[2], record[3],
+        record[4], record[5], record[6], record[7], record[8], record[9]))
+  end
+  file:close()
+  return file_name
+end
+
+return profiler
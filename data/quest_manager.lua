@@ -1,5 +1,7 @@
 -- This script handles global behavior of this quest,
 -- that is, things not related to a particular savegame.
+local entity_registry = require("entity_registry")
+local savegame_summary = require("savegame_summary")
 local quest_manager = {}
 
 -- Initialize map features specific to this quest.
@@ -7,6 +9,9 @@ local function initialize_map()
 
   local map_meta = sol.main.get_metatable("map")
 
+  -- Groups of entities by name prefix for map scripts.
+  entity_registry.initialize()
+
   function map_meta:move_camera(x, y, speed, callback, delay_before, delay_after)
 
     local camera = self:get_camera()
@@ -109,11 +114,35 @@ local function initialize_entities()
   initialize_enemies()
 end
 
+-- Initializes savegame features specific to this quest.
+local function initialize_game()
+
+  local game_meta = sol.main.get_metatable("game")
+
+  -- Count the play time and write the summary of the savegame at each save.
+  local save = game_meta.save
+  function game_meta:save()
+
+    if self.play_time_start ~= nil then
+      local now = sol.main.get_elapsed_time()
+      local play_time = self:get_value("play_time") or 0
+      self:set_value("play_time", play_time + math.floor((now - self.play_time_start) / 1000))
+      self.play_time_start = now - (now - self.play_time_start) % 1000
+    end
+
+    save(self)
+    if self.file_name ~= nil then
+      savegame_summary.write(self, self.file_name)
+    end
+  end
+end
+
 -- Performs global initializations specific to this quest.
 function quest_manager:initialize_quest()
 
   initialize_map()
   initialize_entities()
+  initialize_game()
 end
 
 return quest_manager
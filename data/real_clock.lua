@@ -0,0 +1,49 @@
+-- Real time in milliseconds, to measure loads and the startup.
+--
+-- sol.main.get_elapsed_time() is the simulated time of the engine:
+-- it does not advance while a single update loads a map or a menu.
+-- os.clock() is the processor time, which leaves out the time spent
+-- waiting for files. With LuaJIT, the system clock is used instead.
+-- Without it, this falls back to the simulated time.
+--
+-- Usage:
+-- local real_clock = require("real_clock")
+-- local start_time = real_clock.get_time()
+
+local real_clock = {}
+
+local get_time = sol.main.get_elapsed_time
+local has_ffi, ffi = pcall(require, "ffi")
+if has_ffi then
+  if ffi.os == "Windows" then
+    ffi.cdef[[
+      int QueryPerformanceCounter(int64_t* count);
+      int QueryPerformanceFrequency(int64_t* frequency);
+    ]]
+    local value = ffi.new("int64_t[1]")
+    ffi.C.QueryPerformanceFrequency(value)
+    local frequency = tonumber(value[0])
+    get_time = function()
+      ffi.C.QueryPerformanceCounter(value)
+      return tonumber(value[0]) * 1000 / frequency
+    end
+  else
+    local usec_type = ffi.os == "OSX" and "int" or "long"
+    ffi.cdef([[
+      struct real_clock_timeval { long tv_sec; ]] .. usec_type .. [[ tv_usec; };
+      int gettimeofday(struct real_clock_timeval* tv, void* tz);
+    ]])
+    local time_value = ffi.new("struct real_clock_timeval")
+    get_time = function()
+      ffi.C.gettimeofday(time_value, nil)
+      return tonumber(time_value.tv_sec) * 1000 + tonumber(time_value.tv_usec) / 1000
+    end
+  end
+end
+
+-- Returns the real time in milliseconds since an arbitrary origin.
+function real_clock.get_time()
+  return get_time()
+end
+
+return real_clock
@@ -0,0 +1,105 @@
+-- Small summary of each savegame file, written next to it at each save
+-- (save1.dat -> save1_summary.dat): player name, life, play time and number
+-- of dungeons finished.
+--
+-- The savegame selection menu only reads the summaries
+-- instead of loading the full savegames. Each summary also stores the size
+-- and a hash of its savegame file: if the savegame was changed outside the
+-- game, the summary is ignored and the menu loads the savegame.
+--
+-- Savegames must be loaded with savegame_summary.load() so that the
+-- summary is written when they are saved.
+
+local savegame_summary = {}
+
+local num_dungeons = 10  -- See dungeons.lua.
+
+local function get_summary_file_name(file_name)
+  return file_name:gsub("%.dat$", "") .. "_summary.dat"
+end
+
+-- Returns the size and a hash of a savegame file, or nil if it cannot be read.
+local function get_savegame_signature(file_name)
+
+  local file = sol.file.open(file_name, "rb")
+  if file == nil then
+    return nil
+  end
+  local content = file:read("*a") or ""
+  file:close()
+
+  local hash = 5381
+  for i = 1, #content do
+    hash = (hash * 33 + content:byte(i)) % 4294967296
+  end
+  return #content, hash
+end
+
+-- Loads a savegame and remembers its file name,
+-- so that its summary is written when it is saved.
+function savegame_summary.load(file_name)
+
+  local game = sol.game.load(file_name)
+  game.file_name = file_name
+  return game
+end
+
+-- Returns the summary of a savegame file, or nil if there is no summary.
+function savegame_summary.read(file_name)
+
+  local file = sol.file.open(get_summary_file_name(file_name))
+  if file == nil then
+    return nil
+  end
+  local chunk = loadstring(file:read("*a"))
+  file:close()
+  if chunk == nil then
+    return nil
+  end
+
+  local summary = nil
+  setfenv(chunk, {
+    summary = function(properties)
+      summary = properties
+    end,
+  })
+  if not pcall(chunk) or summary == nil then
+    return nil
+  end
+
+  local size, hash = get_savegame_signature(file_name)
+  if summary.savegame_size ~= size or summary.savegame_hash ~= hash then
+    return nil  -- The savegame was changed without writing the summary.
+  end
+  return summary
+end
+
+-- Writes the summary of a game.
+function savegame_summary.write(game, file_name)
+
+  local num_dungeons_finished = 0
+  for index = 1, num_dungeons do
+    if game:get_value("dungeon_" .. index .. "_finished") then
+      num_dungeons_finished = num_dungeons_finished + 1
+    end
+  end
+
+  local size, hash = get_savegame_signature(file_name)
+  local file = sol.file.open(get_summary_file_name(file_name), "w")
+  file:write("summary{\n")
+  file:write(string.format("  player_name = %q,\n", game:get_value("player_name") or ""))
+  file:write(string.format("  life = %d,\n", game:get_life()))
+  file:write(string.format("  max_life = %d,\n", game:get_max_life()))
+  file:write(string.format("  play_time = %d,\n", game:get_value("play_time") or 0))
+  file:write(string.format("  dungeons_finished = %d,\n", num_dungeons_finished))
+  file:write(string.format("  savegame_size = %d,\n", size or 0))
+  file:write(string.format("  savegame_hash = %.0f,\n", hash or 0))
+  file:write("}\n")
+  file:close()
+end
+
+function savegame_summary.delete(file_name)
+  sol.file.remove(get_summary_file_name(file_name))
+end
+
+return savegame_summary
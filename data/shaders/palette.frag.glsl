@@ -0,0 +1,40 @@
+// Replaces some colors of the texture by other ones.
+// The palette texture is 16x2 pixels: row 0 has the colors to replace
+// and row 1 the replacement colors, only for the first palette_size columns.
+// See enemies/lib/palettes.lua.
+
+#if __VERSION__ >= 130
+#define COMPAT_VARYING in
+#define COMPAT_TEXTURE texture
+out vec4 FragColor;
+#else
+#define COMPAT_VARYING varying
+#define FragColor gl_FragColor
+#define COMPAT_TEXTURE texture2D
+#endif
+
+#ifdef GL_ES
+precision mediump float;
+#endif
+
+uniform sampler2D sol_texture;
+uniform sampler2D palette;
+uniform float palette_size;
+COMPAT_VARYING vec2 sol_vtex_coord;
+COMPAT_VARYING vec4 sol_vcolor;
+
+void main() {
+  vec4 color = COMPAT_TEXTURE(sol_texture, sol_vtex_coord);
+  for (int i = 0; i < 16; ++i) {
+    if (float(i) >= palette_size) {
+      break;
+    }
+    float x = (float(i) + 0.5) / 16.0;
+    vec3 source = COMPAT_TEXTURE(palette, vec2(x, 0.25)).rgb;
+    if (distance(color.rgb, source) < 0.004) {
+      color.rgb = COMPAT_TEXTURE(palette, vec2(x, 0.75)).rgb;
+      break;
+    }
+  }
+  FragColor = color * sol_vcolor;
+}
@@ -0,0 +1,150 @@
+-- Loads the sound effects progressively instead of all at once.
+--
+-- sol.audio.preload_sounds() decodes all sounds in one go, which blocks
+-- the screen for a while and keeps every sound in memory.
+-- Instead, the sounds needed right away are loaded first, then the common
+-- ones, one sound at each step. The other sounds are loaded by the engine
+-- the first time they are played.
+--
+-- The engine has no function to load a single sound: a sound gets loaded
+-- by playing it with the volume set to zero.
+-- Loaded sounds are never freed by the engine, so rare sounds are only
+-- loaded when needed.
+--
+-- Usage:
+-- local sound_manager = require("sound_manager")
+-- sound_manager.start_preloading()
+
+local sound_manager = {}
+
+-- Sounds played in menus, dialogs and by the hero all the time.
+local essential_sounds = {
+  "cursor",
+  "ok",
+  "wrong",
+  "danger",
+  "message_letter",
+  "message_end",
+  "pause_open",
+  "pause_closed",
+  "sword1",
+  "sword2",
+  "sword3",
+  "sword4",
+  "hero_hurt",
+  "picked_rupee",
+}
+
+-- Sounds heard in most maps.
+local common_sounds = {
+  "secret",
+  "enemy_hurt",
+  "enemy_killed",
+  "monster_hurt",
+  "bush",
+  "lift",
+  "throw",
+  "stone",
+  "jump",
+  "hero_lands",
+  "hero_falls",
+  "splash",
+  "walk_on_grass",
+  "walk_on_water",
+  "sword_tapping",
+  "shield",
+  "heart",
+  "picked_item",
+  "chest_open",
+  "chest_appears",
+  "treasure",
+  "door_open",
+  "door_closed",
+  "door_unlocked",
+  "switch",
+  "stairs_up_start",
+  "stairs_up_end",
+  "stairs_down_start",
+  "stairs_down_end",
+  "warp",
+  "bomb",
+  "explosion",
+  "rupee_counter",
+  "rupee_counter_end",
+}
+
+local essential_step_delay = 10
+local common_step_delay = 100
+
+-- Sounds already loaded, indexed by id.
+local loaded_sounds = {}
+
+-- Remember the sounds played, they are loaded now.
+local play_sound = sol.audio.play_sound
+function sol.audio.play_sound(sound_id)
+
+  loaded_sounds[sound_id] = true
+  return play_sound(sound_id)
+end
+
+-- Makes the engine load a sound without hearing it.
+local function load_sound(sound_id)
+
+  local volume = sol.audio.get_sound_volume()
+  sol.audio.set_sound_volume(0)
+  play_sound(sound_id)
+  sol.audio.set_sound_volume(volume)
+  loaded_sounds[sound_id] = true
+end
+
+-- Returns whether a sound was already played or loaded.
+function sound_manager.is_loaded(sound_id)
+  return loaded_sounds[sound_id] == true
+end
+
+-- Returns the ids of the sounds played or loaded, sorted.
+function sound_manager.get_loaded_sounds()
+
+  local sound_ids = {}
+  for sound_id in pairs(loaded_sounds) do
+    sound_ids[#sound_ids + 1] = sound_id
+  end
+  table.sort(sound_ids)
+  return sound_ids
+end
+
+-- Starts loading the essential sounds and then the common ones
+-- in the background.
+function sound_manager.start_preloading()
+
+  local sound_lists = { essential_sounds, common_sounds }
+  local step_delays = { essential_step_delay, common_step_delay }
+  local list_index, sound_index = 1, 0
+
+  local function load_next_sound()
+
+    -- Find the next sound not played yet.
+    local sound_id
+    repeat
+      sound_index = sound_index + 1
+      sound_id = sound_lists[list_index][sound_index]
+      if sound_id == nil then
+        list_index = list_index + 1
+        sound_index = 0
+        if sound_lists[list_index] == nil then
+          return false  -- Finished.
+        end
+        -- Continue at the speed of this list.
+        sol.timer.start(sol.main, step_delays[list_index], load_next_sound)
+        return false
+      end
+    until not loaded_sounds[sound_id]
+
+    load_sound(sound_id)
+    return true  -- Repeat the timer.
+  end
+
+  sol.timer.start(sol.main, step_delays[list_index], load_next_sound)
+end
+
+return sound_manager
@@ -0,0 +1,97 @@
+-- Measures the phases of the startup and loads the next menus in advance.
+--
+-- The menus shown at startup are only loaded when they are about to be
+-- needed: sol.main:on_started() just starts the Solarus logo, and the
+-- scripts and images of the following menus are loaded in the background
+-- while the current one animates, one step at a time.
+--
+-- Each phase of the startup (settings loaded, first frame drawn, logos
+-- finished, title screen ready, savegame selection ready) is timed in real
+-- time (see real_clock.lua), since several phases are reached within the
+-- same update of the engine.
+-- In debug mode, the times are printed when each phase is reached.
+--
+-- Usage:
+-- local startup = require("startup")
+-- startup.start()
+-- startup.mark("settings")
+-- startup.prefetch(function() require("menus/team_logo") end)
+
+local real_clock = require("real_clock")
+
+local startup = {}
+
+local step_delay = 10
+local start_time, start_clock = 0, 0
+local last_time = 0
+local marks = {}        -- Time of each phase reached, indexed by name.
+local prefetch_queue = {}
+local prefetch_timer = nil
+
+-- Starts measuring the startup from now.
+function startup.start()
+
+  start_time = real_clock.get_time()
+  start_clock = os.clock()
+  last_time = 0
+  marks = {}
+
+  -- Measure the first frame drawn.
+  local frame_menu = {}
+  function frame_menu:on_draw()
+    startup.mark("first_frame")
+    sol.menu.stop(self)
+  end
+  sol.menu.start(sol.main, frame_menu)
+end
+
+-- Records that a phase of the startup is reached.
+-- Only the first time counts.
+function startup.mark(phase)
+
+  if marks[phase] ~= nil then
+    return
+  end
+
+  local time = real_clock.get_time() - start_time
+  marks[phase] = time
+  if sol.main.is_debug_enabled() then
+    print(string.format("Startup: %s after %.1f ms (+%.1f ms, %.1f ms of processor time)",
+        phase, time, time - last_time, (os.clock() - start_clock) * 1000))
+  end
+  last_time = time
+end
+
+-- Returns the time in milliseconds when a phase was reached,
+-- or nil if it was not reached yet.
+function startup.get_mark(phase)
+  return marks[phase]
+end
+
+-- Runs a function in the background, after the ones already queued.
+-- Each function runs at its own step so that frames can be drawn between.
+function startup.prefetch(callback)
+
+  prefetch_queue[#prefetch_queue + 1] = callback
+  if prefetch_timer ~= nil then
+    return
+  end
+
+  prefetch_timer = sol.timer.start(sol.main, step_delay, function()
+    local next_callback = table.remove(prefetch_queue, 1)
+    local repeat_timer = prefetch_queue[1] ~= nil
+    if not repeat_timer then
+      prefetch_timer = nil
+    end
+    if next_callback ~= nil then
+      -- An error must not stop the next ones.
+      local success, message = pcall(next_callback)
+      if not success then
+        print("Error: prefetch failed: " .. tostring(message))
+      end
+    end
+    return repeat_timer
+  end)
+end
+
+return startup
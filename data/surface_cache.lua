@@ -0,0 +1,147 @@
+-- Images loaded from PNG files, shared by the menus, the HUD and the maps.
+--
+-- Menus create the same images each time they are started. Getting them
+-- from this cache decodes each file only once:
+--
+-- local surface_cache = require("surface_cache")
+--
+-- function menu:on_started()
+--   self.icons_img = surface_cache.get(self, "menus/icons.png")
+-- end
+--
+-- function menu:on_finished()
+--   surface_cache.release(self)
+-- end
+--
+-- An image is shared by all its users, so they must not modify it
+-- (position, opacity, blend mode, content...).
+-- An image is in use as long as a user has not released it. Users are
+-- weak references: a user that is garbage-collected releases its images too.
+-- Images no longer in use stay in the cache until the total size of the
+-- images exceeds the budget: then the least recently used ones are freed.
+
+local surface_cache = {}
+
+local max_bytes = 16 * 1024 * 1024
+local total_bytes = 0
+local use_counter = 0
+
+-- Each entry has the surface, its size in bytes, its users
+-- and the last time it was requested. Indexed by file name.
+local entries = {}
+local weak_keys = { __mode = "k" }
+
+-- Returns nil for a language-specific image if no language is set.
+local function get_key(file_name, language_specific)
+
+  if language_specific then
+    local language = sol.language.get_language()
+    if language == nil then
+      return nil
+    end
+    return language .. "/" .. file_name
+  end
+  return file_name
+end
+
+local function is_used(entry)
+  return next(entry.users) ~= nil
+end
+
+-- Frees the least recently used images not in use
+-- until the cache fits in the budget.
+local function evict()
+
+  while total_bytes > max_bytes do
+    local oldest_key, oldest_entry
+    for key, entry in pairs(entries) do
+      if not is_used(entry)
+          and (oldest_entry == nil or entry.last_use < oldest_entry.last_use) then
+        oldest_key, oldest_entry = key, entry
+      end
+    end
+
+    if oldest_entry == nil then
+      -- All images are in use.
+      return
+    end
+    entries[oldest_key] = nil
+    total_bytes = total_bytes - oldest_entry.bytes
+  end
+end
+
+-- Returns the entry of a file, loading it if necessary.
+local function get_entry(file_name, language_specific)
+
+  local key = get_key(file_name, language_specific)
+  if key == nil then
+    return nil
+  end
+  local entry = entries[key]
+  if entry == nil then
+    local surface = sol.surface.create(file_name, language_specific)
+    if surface == nil then
+      return nil
+    end
+    local width, height = surface:get_size()
+    entry = {
+      surface = surface,
+      bytes = width * height * 4,
+      users = setmetatable({}, weak_keys),
+    }
+    entries[key] = entry
+    total_bytes = total_bytes + entry.bytes
+  end
+
+  use_counter = use_counter + 1
+  entry.last_use = use_counter
+  return entry
+end
+
+-- Returns the image of a file for a user, loading it if necessary.
+-- Same parameters as sol.surface.create().
+function surface_cache.get(user, file_name, language_specific)
+
+  local entry = get_entry(file_name, language_specific)
+  if entry == nil then
+    return nil
+  end
+  entry.users[user] = true
+  evict()
+  return entry.surface
+end
+
+-- Loads the image of a file in advance, for a menu about to start.
+-- The image is not in use until a user gets it.
+function surface_cache.preload(file_name, language_specific)
+
+  get_entry(file_name, language_specific)
+  evict()
+end
+
+-- Indicates that a user no longer needs the images it got.
+function surface_cache.release(user)
+
+  for _, entry in pairs(entries) do
+    entry.users[user] = nil
+  end
+  evict()
+end
+
+-- Returns the maximum size in bytes of the images kept when not in use.
+function surface_cache.get_max_bytes()
+  return max_bytes
+end
+
+function surface_cache.set_max_bytes(bytes)
+
+  max_bytes = bytes
+  evict()
+end
+
+-- Returns the size in bytes of the images currently in the cache.
+function surface_cache.get_total_bytes()
+  return total_bytes
+end
+
+return surface_cache
@@ -0,0 +1,35 @@
+# Writes the manifest of the data files precompiled to LuaJIT bytecode:
+# the LuaJIT version that compiled them and its GC64 mode, and the SHA-1
+# of the source of each one, to know which sources a package was built from.
+# main.lua reads the version and the mode to check that the engine can load
+# the files: GC64 bytecode does not load in other builds, and conversely.
+#
+# Usage: cmake -D LUAJIT_EXECUTABLE=luajit -D DATA_DIR=data
+#              -D FILES=file_1,file_2 -D OUTPUT=bytecode_manifest.dat
+#              -P make_bytecode_manifest.cmake
+
+execute_process(
+  COMMAND ${LUAJIT_EXECUTABLE} -v
+  OUTPUT_VARIABLE luajit_version
+  OUTPUT_STRIP_TRAILING_WHITESPACE
+)
+# "LuaJIT 2.1.0-beta3 -- Copyright ..." -> "LuaJIT 2.1"
+string(REGEX MATCH "^LuaJIT [0-9]+\\.[0-9]+" luajit_version "${luajit_version}")
+
+# "true" or "false" (LuaJIT 2.0 has no GC64 mode)
+execute_process(
+  COMMAND ${LUAJIT_EXECUTABLE} -e "io.write(tostring(require('ffi').abi('gc64')))"
+  OUTPUT_VARIABLE luajit_gc64
+)
+
+string(REPLACE "," ";" files "${FILES}")
+list(SORT files)
+
+set(manifest "-- Generated by tools/make_bytecode_manifest.cmake. Do not edit.\n\n")
+set(manifest "${manifest}luajit{ version = \"${luajit_version}\", gc64 = ${luajit_gc64} }\n")
+foreach(file ${files})
+  file(SHA1 ${DATA_DIR}/${file} source_sha1)
+  set(manifest "${manifest}bytecode{ file = \"${file}\", source_sha1 = \"${source_sha1}\" }\n")
+endforeach()
+
+file(WRITE ${OUTPUT} "${manifest}")
@@ -0,0 +1,90 @@
+-- Generates the index of the chests of each dungeon.
+-- The map submenu of the pause menu reads this index instead of parsing
+-- the data files of all maps of the dungeon at runtime.
+--
+-- Usage: lua make_dungeon_index.lua data_dir output_file
+--
+-- The output file has one entry per chest like
+-- chest{ dungeon = 1, floor = 0, x = 400, y = 293, big = false, savegame_variable = "b54" }
+-- where x and y are relative to the floor.
+
+local tools_dir = arg[0]:match("^(.*[/\\])") or "./"
+package.path = tools_dir .. "?.lua;" .. package.path
+local quest_data = require("quest_data")
+
+local data_dir, output_file_name = arg[1], arg[2]
+if data_dir == nil or output_file_name == nil then
+  io.stderr:write("Usage: ", arg[0], " data_dir output_file\n")
+  os.exit(1)
+end
+
+local chest_keys = { "dungeon", "floor", "x", "y", "big", "savegame_variable" }
+
+local dungeons = quest_data.load_dungeons(data_dir)
+local output_file = quest_data.open_output(output_file_name, "make_dungeon_index.lua")
+local num_errors = 0
+
+for _, dungeon_index in ipairs(quest_data.sorted_indexes(dungeons)) do
+
+  local dungeon = dungeons[dungeon_index]
+  local boss = dungeon.boss
+  local boss_found = false
+
+  for _, map_id in ipairs(dungeon.maps) do
+
+    local map_file_name = data_dir .. "/maps/" .. map_id .. ".dat"
+    local current_floor, current_map_x, current_map_y
+
+    quest_data.parse(map_file_name, {
+
+      properties = function(map_properties)
+        current_floor = map_properties.floor
+        current_map_x = map_properties.x
+        current_map_y = map_properties.y
+      end,
+
+      chest = function(chest_properties)
+        if current_floor ~= nil then
+          quest_data.write_entry(output_file, "chest", {
+            dungeon = dungeon_index,
+            floor = current_floor,
+            x = current_map_x + chest_properties.x,
+            y = current_map_y + chest_properties.y,
+            big = (chest_properties.sprite == "entities/big_chest"),
+            savegame_variable = chest_properties.treasure_savegame_variable,
+          }, chest_keys)
+        end
+      end,
+
+      enemy = function(enemy_properties)
+        -- Check that the boss position of dungeons.lua is still up to date.
+        if boss ~= nil
+            and boss.savegame_variable ~= nil
+            and enemy_properties.savegame_variable == boss.savegame_variable then
+          boss_found = true
+          local x = current_map_x + enemy_properties.x
+          local y = current_map_y + enemy_properties.y
+          if current_floor ~= boss.floor or x ~= boss.x or y ~= boss.y then
+            io.stderr:write("Warning: boss of dungeon ", dungeon_index,
+                " is on floor ", tostring(current_floor), " at ", x, ",", y,
+                " in map ", map_id, " but dungeons.lua says floor ",
+                tostring(boss.floor), " at ", boss.x, ",", boss.y, "\n")
+          end
+        end
+      end,
+    })
+  end
+
+  if boss ~= nil and boss.savegame_variable ~= nil and not boss_found then
+    io.stderr:write("Error: cannot find the boss of dungeon ", dungeon_index,
+        " (savegame variable ", boss.savegame_variable, ") in its maps\n")
+    num_errors = num_errors + 1
+  end
+end
+
+output_file:close()
+
+if num_errors > 0 then
+  os.remove(output_file_name)
+  os.exit(1)
+end
@@ -0,0 +1,82 @@
+-- Lists the characters that a font has to provide for some languages.
+-- The Chinese font is huge: the build only keeps the characters listed by
+-- this script (see CMakeLists.txt).
+--
+-- Usage: lua make_font_text.lua data_dir output_file language_1 [language_2 ...]
+--
+-- The output file is an utf-8 text file with each character once.
+-- It contains the characters of the dialogs and strings of the languages,
+-- the names of the languages and the printable ASCII characters
+-- (savegame names can use them).
+
+local tools_dir = arg[0]:match("^(.*[/\\])") or "./"
+package.path = tools_dir .. "?.lua;" .. package.path
+local quest_data = require("quest_data")
+
+local data_dir, output_file_name = arg[1], arg[2]
+if data_dir == nil or output_file_name == nil or arg[3] == nil then
+  io.stderr:write("Usage: ", arg[0], " data_dir output_file language_1 [language_2 ...]\n")
+  os.exit(1)
+end
+
+local languages = {}
+for i = 3, #arg do
+  languages[arg[i]] = true
+end
+
+local characters = {}
+
+local function add_text(text)
+
+  if type(text) ~= "string" then
+    return
+  end
+  -- One utf-8 character: a first byte and its continuation bytes.
+  for character in text:gmatch("[\1-\127\192-\255][\128-\191]*") do
+    if character ~= "\n" and character ~= "\r" then
+      characters[character] = true
+    end
+  end
+end
+
+for byte = 32, 126 do
+  characters[string.char(byte)] = true
+end
+
+-- Names of the languages, displayed by the language menu.
+quest_data.parse(data_dir .. "/project_db.dat", {
+  language = function(properties)
+    if languages[properties.id] then
+      add_text(properties.description)
+    end
+  end,
+})
+
+for language in pairs(languages) do
+  local text_dir = data_dir .. "/languages/" .. language .. "/text/"
+
+  quest_data.parse(text_dir .. "dialogs.dat", {
+    dialog = function(properties)
+      add_text(properties.text)
+    end,
+  })
+
+  quest_data.parse(text_dir .. "strings.dat", {
+    text = function(properties)
+      add_text(properties.value)
+    end,
+  })
+end
+
+local sorted_characters = {}
+for character in pairs(characters) do
+  sorted_characters[#sorted_characters + 1] = character
+end
+table.sort(sorted_characters)
+
+local output_file, error_message = io.open(output_file_name, "w")
+if output_file == nil then
+  error(error_message, 0)
+end
+output_file:write(table.concat(sorted_characters), "\n")
+output_file:close()
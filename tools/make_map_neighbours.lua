@@ -0,0 +1,92 @@
+-- Generates the index of the maps reachable from each map.
+-- While the hero is on a map, the game loads in advance the sprites of the
+-- maps that teletransporters lead to (see prefetch.lua).
+--
+-- Usage: lua make_map_neighbours.lua data_dir output_file
+--
+-- The output file has entries like
+-- neighbour{ map = "3", destination_map = "4" }
+-- sprite{ map = "4", id = "enemies/tentacle" }
+-- Sprites are the ones of the entities of the map, only if they exist.
+
+local tools_dir = arg[0]:match("^(.*[/\\])") or "./"
+package.path = tools_dir .. "?.lua;" .. package.path
+local quest_data = require("quest_data")
+
+local data_dir, output_file_name = arg[1], arg[2]
+if data_dir == nil or output_file_name == nil then
+  io.stderr:write("Usage: ", arg[0], " data_dir output_file\n")
+  os.exit(1)
+end
+
+local neighbour_keys = { "map", "destination_map" }
+local sprite_keys = { "map", "id" }
+
+-- Returns whether the animation set of a sprite exists.
+local existing_sprites = {}
+local function sprite_exists(sprite_id)
+
+  local exists = existing_sprites[sprite_id]
+  if exists == nil then
+    local file = io.open(data_dir .. "/sprites/" .. sprite_id .. ".dat")
+    exists = file ~= nil
+    if file ~= nil then
+      file:close()
+    end
+    existing_sprites[sprite_id] = exists
+  end
+  return exists
+end
+
+local map_ids = {}
+quest_data.parse(data_dir .. "/project_db.dat", {
+  map = function(properties)
+    map_ids[#map_ids + 1] = properties.id
+  end,
+})
+table.sort(map_ids)
+
+local output_file = quest_data.open_output(output_file_name, "make_map_neighbours.lua")
+
+for _, map_id in ipairs(map_ids) do
+
+  local destination_maps = {}
+  local sprites = {}
+  local function add_sprite(sprite_id)
+    if sprite_id ~= nil and sprite_exists(sprite_id) then
+      sprites[sprite_id] = true
+    end
+  end
+
+  for _, entry in ipairs(quest_data.read_entries(data_dir .. "/maps/" .. map_id .. ".dat")) do
+    local properties = entry.properties
+    if entry.name == "teletransporter" then
+      local destination_map = properties.destination_map
+      if destination_map ~= nil and destination_map ~= map_id then
+        destination_maps[destination_map] = true
+      end
+    elseif entry.name == "enemy" then
+      -- Enemy scripts usually create the sprite of their breed.
+      add_sprite("enemies/" .. properties.breed)
+      add_sprite(properties.sprite)
+    elseif entry.name ~= "tile" and entry.name ~= "properties" then
+      add_sprite(properties.sprite)
+    end
+  end
+
+  for _, destination_map in ipairs(quest_data.sorted_indexes(destination_maps)) do
+    quest_data.write_entry(output_file, "neighbour", {
+      map = map_id,
+      destination_map = destination_map,
+    }, neighbour_keys)
+  end
+
+  for _, sprite_id in ipairs(quest_data.sorted_indexes(sprites)) do
+    quest_data.write_entry(output_file, "sprite", {
+      map = map_id,
+      id = sprite_id,
+    }, sprite_keys)
+  end
+end
+
+output_file:close()
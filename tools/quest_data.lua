@@ -0,0 +1,114 @@
+-- Helpers to read the data files of the quest from build tools.
+-- Data files are Lua code: they are run in an environment that only
+-- provides the functions the tool is interested in.
+
+local quest_data = {}
+
+-- Loads a Lua file, optionally with a specific environment,
+-- and returns the chunk.
+-- Works with Lua 5.1, LuaJIT and Lua 5.2+.
+function quest_data.load_file(file_name, environment)
+
+  local chunk, error_message
+  if environment == nil then
+    chunk, error_message = loadfile(file_name)
+  elseif setfenv ~= nil then
+    chunk, error_message = loadfile(file_name)
+    if chunk ~= nil then
+      setfenv(chunk, environment)
+    end
+  else
+    chunk, error_message = loadfile(file_name, "bt", environment)
+  end
+
+  if chunk == nil then
+    error(error_message, 0)
+  end
+  return chunk
+end
+
+-- Runs a data file. Each entry of the file (like tile{} or chest{})
+-- calls the function of the same name in handlers if any.
+-- Other entries are ignored.
+function quest_data.parse(file_name, handlers)
+
+  local environment = setmetatable({}, {
+    __index = function(_, key)
+      return handlers[key] or function() end
+    end
+  })
+
+  quest_data.load_file(file_name, environment)()
+end
+
+-- Returns the game.dungeons table defined by dungeons.lua.
+function quest_data.load_dungeons(data_dir)
+
+  local game = {}
+  quest_data.load_file(data_dir .. "/dungeons.lua")()(game)
+  return game.dungeons
+end
+
+-- Returns the indexes of an array-like table with holes, sorted.
+function quest_data.sorted_indexes(array)
+
+  local indexes = {}
+  for index in pairs(array) do
+    indexes[#indexes + 1] = index
+  end
+  table.sort(indexes)
+  return indexes
+end
+
+-- Returns the Lua representation of a number, boolean or string value.
+local function serialize_value(value)
+
+  if type(value) == "string" then
+    return string.format("%q", value)
+  end
+  return tostring(value)
+end
+
+-- Writes an entry like name{ key_1 = value_1, key_2 = value_2 }
+-- to an open file.
+-- keys is the ordered list of properties to write. Nil properties are skipped.
+function quest_data.write_entry(file, name, properties, keys)
+
+  local fields = {}
+  for _, key in ipairs(keys) do
+    local value = properties[key]
+    if value ~= nil then
+      fields[#fields + 1] = key .. " = " .. serialize_value(value)
+    end
+  end
+  file:write(name, "{ ", table.concat(fields, ", "), " }\n")
+end
+
+-- Runs a data file and returns all its entries in order,
+-- as an array of { name = "tile", properties = { ... } }.
+function quest_data.read_entries(file_name)
+
+  local entries = {}
+  local handlers = setmetatable({}, {
+    __index = function(_, name)
+      return function(properties)
+        entries[#entries + 1] = { name = name, properties = properties }
+      end
+    end
+  })
+  quest_data.parse(file_name, handlers)
+  return entries
+end
+
+-- Opens an output file for writing and writes the generated file header.
+function quest_data.open_output(file_name, generator_name)
+
+  local file, error_message = io.open(file_name, "w")
+  if file == nil then
+    error(error_message, 0)
+  end
+  file:write("-- Generated by tools/", generator_name, ". Do not edit.\n\n")
+  return file
+end
+
+return quest_data